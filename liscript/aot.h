@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * AOT  interface
+ * liscript --aot  C++ ҽ  header includeؼ runtime Բ link˴ϴ.
+ *  aot::module_registrar ڽ ϰ, ũƮ loadModule մϴ.
+ * keyword   ȿ C++   ǰ,  Ʒ helper  runtime óմϴ.
+ **/
+
+struct s_object;
+struct s_string;
+struct s_function;
+struct s_array;
+
+struct expression;
+struct function_template;
+
+/**
+ * variable  ϳ ϴ üԴϴ.
+ *  Ÿ boolean, number, undefined, object 4Դϴ.
+ * boolean true/false Դϴ.
+ * number 64Ʈ ε ҼԴϴ
+ * undefined   Ÿϴ.
+ * object  ŸԴϴ.
+ **/
+
+enum class var_type { boolean, number, undefined, object };
+
+struct variable
+{
+	var_type type;
+	union
+	{
+		bool v_boolean;
+		double v_number;
+		s_object* v_object;
+		std::uint64_t raw;
+	};
+
+	bool operator ==(variable rhs)
+	{
+		return (type == rhs.type && raw == rhs.raw);
+	}
+	bool operator !=(variable rhs)
+	{
+		return !(*this == rhs);
+	}
+
+	static variable boolean(bool b)
+	{
+		variable ret;
+		ret.type = var_type::boolean;
+		ret.v_boolean = b;
+		return ret;
+	}
+	static variable number(double d)
+	{
+		variable ret;
+		ret.type = var_type::number;
+		ret.v_number = d;
+		return ret;
+	}
+	static variable undefined()
+	{
+		variable ret;
+		ret.type = var_type::undefined;
+		ret.raw = 0;
+		return ret;
+	}
+	static variable object(s_object* obj)
+	{
+		variable ret;
+		ret.type = var_type::object;
+		ret.raw = 0;
+		ret.v_object = obj;
+		return ret;
+	}
+};
+
+// native Լ arguments ϰų ȯؼ  ˴ϴ. ȣ   frame-local 迭  ֽϴ.
+using native_fn_t = variable (*)(variable this_var, s_array* arguments);
+
+extern s_object* global_object;
+extern variable this_var;
+extern variable prev_var;
+
+bool to_conditional(variable var);
+std::int64_t to_integer(double n);
+
+namespace aot
+{
+	using module_fn = variable (*)();
+
+	//  ڿ  ̸ մϴ.
+	struct module_registrar
+	{
+		module_registrar(const char* name, module_fn fn);
+	};
+
+	//  Դϴ.  static  ϸ GC ȸ ʽϴ.
+	s_string* name(const char* str);
+	variable string(const char* str);
+
+	// number ƴϸ not_number_error ϴ.
+	double number(variable v);
+
+	variable getl(s_string* name);
+	void setl(s_string* name, variable val);
+
+	// getf/setf  objectԴϴ. object ƴϰų null̸ ܸ ϴ.
+	s_object* field_object(variable v);
+	variable getf(s_object* obj, s_string* name);
+	void setf(s_object* obj, s_string* name, variable val);
+
+	// (obj name args...)   ԼԴϴ.  nullptrԴϴ.
+	s_function* method(variable obj, s_string* name);
+	// Լ ƴϸ list_evaluate_error ϴ.
+	s_function* function(variable v);
+	variable call(s_function* fn, variable this_value, const variable* args, std::size_t count);
+
+	// new Դϴ. Լ ƴϸ ܸ ϴ.
+	s_function* constructor(variable v);
+	variable construct(s_function* ctor, const variable* args, std::size_t count);
+
+	variable array(const variable* items, std::size_t count);
+
+	// ϵ Լ  template α׷   ˴ϴ.
+	const function_template* native_template(const char* const* parameters, std::size_t count, bool is_variadic, native_fn_t fn);
+	// func ŰԴϴ. name ִٸ prototype  setlմϴ.
+	variable make_function(const function_template* templ, s_string* name);
+
+	//    ҽ  ξٰ interpreter մϴ.
+	const expression* parse(const char* source);
+	variable eval(const expression* expr);
+}
@@ -0,0 +1,41 @@
+#ifdef _WIN32
+# include <Windows.h>
+#else
+# include <sys/mman.h>
+#endif
+#include "jitmem.h"
+
+namespace jitmem
+{
+	void* allocate(std::size_t size)
+	{
+#ifdef _WIN32
+		return VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#else
+		void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		return (ptr != MAP_FAILED) ? ptr : nullptr;
+#endif
+	}
+
+	bool protect(void* ptr, std::size_t size)
+	{
+#ifdef _WIN32
+		DWORD old;
+		if (!VirtualProtect(ptr, size, PAGE_EXECUTE_READ, &old))
+			return false;
+		FlushInstructionCache(GetCurrentProcess(), ptr, size);
+		return true;
+#else
+		return mprotect(ptr, size, PROT_READ | PROT_EXEC) == 0;
+#endif
+	}
+
+	void release(void* ptr, std::size_t size)
+	{
+#ifdef _WIN32
+		VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+		munmap(ptr, size);
+#endif
+	}
+}
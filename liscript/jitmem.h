@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+
+namespace jitmem
+{
+	void* allocate(std::size_t size);
+	bool protect(void* ptr, std::size_t size);
+	void release(void* ptr, std::size_t size);
+
+	class block
+	{
+	public:
+		explicit block(std::size_t size)
+		{
+			m_size = size;
+			m_ptr = allocate(size);
+		}
+		~block()
+		{
+			if (m_ptr != nullptr)
+				release(m_ptr, m_size);
+		}
+		block(const block&) = delete;
+		block& operator =(const block&) = delete;
+
+		void* get() const
+		{
+			return m_ptr;
+		}
+		std::size_t size() const
+		{
+			return m_size;
+		}
+		bool protect()
+		{
+			return jitmem::protect(m_ptr, m_size);
+		}
+	private:
+		void* m_ptr;
+		std::size_t m_size;
+	};
+}
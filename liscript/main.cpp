@@ -185,11 +185,125 @@
  *     index° ׸ ɴϴ.
  *   func set(index: number, val)
  *     index° ׸  ֽϴ.
+ *   func push(...) -> number
+ *     ڵ 迭  ʷ ְ  ũ⸦ ݴϴ.
+ *   func pop()
+ *      ׸  ݴϴ.  迭̸ out of range ܸ ϴ.
+ *   func reserve(capacity: number)
+ *     capacity ׸   ̸ ϴ. capacity 2^31 - 1 ũų ޸𸮰 ڶ out of range ܸ ϴ.
+ *   func slice(begin: number, /end: number/) -> Array
+ *     begin° end° ձ ׸  迭 ݴϴ. end ϸ 迭 Դϴ.
+ *   func concat(other: Array) -> Array
+ *      迭 ڿ other ̾   迭 ݴϴ.
+ *   func fill(val, /begin: number/, /end: number/) -> Array
+ *     begin° end° ձ val ä  迭 ݴϴ. ϸ 迭 üԴϴ.
+ *   func indexOf(val) -> number
+ *     =  val  ù ׸ index ݴϴ.  -1Դϴ.
+ *   func reverse() -> Array
+ *     ׸    迭 ݴϴ.
+ *   func sort(/compare: function/) -> Array
+ *     ׸ ϰ  迭 ݴϴ. compare ϸ number  մϴ.
+ *     compare (() compare a b) a b տ   ̾ մϴ.
+ *
+ * class Float64Array, Int32Array
+ *   64Ʈ ε Ҽ Ǵ 32Ʈ  ӵ ޸𸮿    迭Դϴ.
+ *   ڷ  ϴ  float64Array, int32Array Լ  ؾ մϴ.
+ *   func size(), get(index: number), set(index: number, val: number)
+ *     Array ϴ. Int32Array int32     out of range ܸ ϴ.
+ *   func sum() -> number, min() -> number, max() -> number
+ *     ׸ , ּڰ, ִ մϴ.  迭 min, max out of range ܸ ϴ.
+ *   func dot(other) -> number
+ *      type  other  մϴ.
+ *   func toArray() -> Array
+ *     ׸ Array մϴ.
+ *   func add(other), mul(other), scale(factor: number), axpy(factor: number, other)  (Float64Array)
+ *     ׸񸶴 other ϰų ϰ, factor ϰų, factor * other    迭 ݴϴ.
+ *
+ * Array, Float64Array, Int32Array  method
+ *    迭   CPU core ϳ  thread óմϴ. Array ׸  number մϴ.
+ *   func parallelSum() -> number
+ *     ׸  մϴ.
+ *   func parallelMinMax() -> Array
+ *     ּڰ ִ (array min max) ݴϴ.  迭̸ out of range ܸ ϴ.
+ *   func parallelReduce(op: string) -> number
+ *     op "+", "*", "min", "max"  ϳԴϴ.
+ *   func parallelMap(op: string, operand: number)
+ *     ׸񸶴 op("+", "-", "*", "/") operand   迭 ݴϴ. typed array Float64Array ݴϴ.
+ *
+ * class RecordArray
+ *    ڷ  object field ϳ Array column   迭Դϴ.
+ *   ڷ  ϴ  recordArray Լ  ؾ մϴ.
+ *   func size() -> number
+ *     ׸  ɴϴ.
+ *   func get(index: number)
+ *     index° ׸ Ű record ݴϴ. record field getf, setf column а ,
+ *     method  prototype ãϴ. field ƴ     ϴ.
+ *   func push(record) -> number
+ *     record field   column  ְ  ũ⸦ ݴϴ.
+ *   func column(field: string) -> Array
+ *     field column ݴϴ. 纻 ƴϹǷ ׸ ٲٸ record Դϴ.
+ *   func fields() -> Array
+ *     field ̸ ݴϴ.
+ *
+ * class Map
+ *   ƹ ̳ key  hash tableԴϴ. (new Map) ϴ.
+ *   number key , string key ,  object  object մϴ.
+ *   prototype   ʽϴ.
+ *   func size() -> number
+ *     ׸  ɴϴ.
+ *   func get(key)
+ *     key  ɴϴ. ٸ undefinedԴϴ.
+ *   func set(key, value) -> Map
+ *     key value ְ ڱ ڽ ݴϴ.
+ *   func has(key) -> boolean
+ *     key ִ Ȯմϴ.
+ *   func delete(key) -> boolean
+ *     key ϴ. ־ٸ trueԴϴ.
+ *   func keys() -> Array
+ *     key ݴϴ.    ʽϴ.
+ *
+ * class String
+ *   string prototypeԴϴ. string ٲ  ϴ.
+ *   substring, split, trim ִ string   ʰ  string buffer ŵϴ.
+ *   func size() -> number
+ *     byte  ɴϴ.
+ *   func substring(begin: number, /end: number/) -> string
+ *     begin° end° ձ byte ݴϴ. end ϸ Դϴ.
+ *   func indexOf(search: string, /from: number/) -> number
+ *     from° ãƼ search ó  ġ ݴϴ.  -1Դϴ.
+ *   func startsWith(prefix: string) -> boolean
+ *     prefix ϴ Ȯմϴ.
+ *   func split(separator: string) -> Array
+ *     separator   ݴϴ. separator  string̸ byte ϴ.
+ *   func trim() -> string
+ *     յ  ڸ  string ݴϴ.
+ *
+ * class StringBuilder
+ *   string ̾ ̴ bufferԴϴ. (new StringBuilder) ϴ.
+ *   func append(values...) -> StringBuilder
+ *     values ʷ  ̰ ڱ ڽ ݴϴ.
+ *     string ״, number boolean, null, undefined ڷ ٲ㼭, StringBuilder   Դϴ.
+ *       object  ƹ͵  ʰ invalid argument ܸ ϴ.
+ *   func size() -> number
+ *     ݱ  byte  ɴϴ.
+ *   func toString() -> string
+ *      string ɴϴ. ٽ appendϱ   string ݴϴ.
+ *   func clear() -> StringBuilder
+ *       ڱ ڽ ݴϴ.
  *
  * object replConfig
  *   repl õ Դϴ.
  *   field dumpExpr: boolean
  *     expr    м   Դϴ. ⺻ falseԴϴ.
+ *   field profileAlloc: boolean
+ *     object, array, string, function Ҵ expression Լ  Դϴ. ⺻ falseԴϴ.
+ *           Ҵ expression Լ  մϴ.
+ *   field tierLog: boolean
+ *     Լ   ٲ   Դϴ. ⺻ falseԴϴ.
+ *   field warmThreshold: number
+ *     Լ  type ߷ Ưȭ AST ϱ ϴ hotnessԴϴ. ⺻ 2Դϴ.
+ *   field jitThreshold: number
+ *     Լ   ϴ hotnessԴϴ. ⺻ 1000Դϴ.
  *
  * object console
  *   ܼ  մϴ.
@@ -197,10 +311,29 @@
  *     obj  ȭ鿡 մϴ.
  *   func readLine() -> string
  *       ǥ Է¿ оԴϴ.
+ *   func heapSnapshot(/path: string/)
+ *     global stackframe   object type prototype ̸  ȭ鿡 մϴ.
+ *     path ־  踦 JSON  path Ͽ մϴ.
+ *   func typeFeedback(fn: function)
+ *     fn     node  operand type, number  handler ٲ,
+ *      Ƚ Ϲ handler ǵ Ƚ մϴ.
+ *   func dynamicSites(fn: function)
+ *     fn  static type inference operand  type     ˻ϴ site մϴ.
  *
  * func parseFloat(str: string) -> number
  *   ڿ ε Ҽ ڷ ٲߴϴ.
  *
+ * func float64Array(source) -> Float64Array
+ * func int32Array(source) -> Int32Array
+ *   source number̸   0 ä 迭, Array typed array̸ ׸  迭 ϴ.
+ *   ̰ 2^31 - 1 ũų ޸𸮰 ڶ out of range ܸ ϴ.
+ *
+ * func recordArray(ctor: function, ...) -> RecordArray
+ *   ctor prototype   (string) field   record array ϴ.
+ *
+ * func loadModule(name: string)
+ *   liscript --aot  Բ   global scope ϰ  expr  ȯմϴ.
+ *
  **/
 
 // boehm-gc
@@ -214,23 +347,51 @@
 #endif
 
 #include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 #include <functional>
 #include <algorithm>
 #include <iterator>
 #include <string>
 #include <vector>
 #include <list>
+#include <deque>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 #include <utility>
 #include <stdexcept>
+#include <exception>
 #include <new>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <cstdlib>
+#include <cstdio>
 #include <cstdint>
 #include <cctype>
 #include <cstring>
 #include <cmath>
 #include <cassert>
+#include <limits>
+
+#if defined(_M_X64) || defined(__x86_64__)
+# include <immintrin.h>
+# ifdef _MSC_VER
+#  include <intrin.h>
+# endif
+#endif
+
+// x86-64 SSE2 ׻   ְ, AVX2 kernel   CPU Ȯ ڿ θϴ.
+#if defined(_M_X64) || defined(__x86_64__)
+# define LISCRIPT_SIMD
+# ifdef _MSC_VER
+#  define LISCRIPT_AVX2
+# else
+#  define LISCRIPT_AVX2 __attribute__((target("avx2")))
+# endif
+#endif
 
 #include <boost/iostreams/stream.hpp>
 #include <boost/iostreams/categories.hpp>
@@ -241,6 +402,8 @@
 namespace io = boost::iostreams;
 
 #include "conlib.h"
+#include "jitmem.h"
+#include "aot.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -278,6 +441,9 @@ MAKE_EXCEPTION(not_integer_error, "number is not a integer");
 MAKE_EXCEPTION(null_reference_error, "null reference error");
 MAKE_EXCEPTION(undefined_error, "undefined error");
 
+MAKE_EXCEPTION(file_open_error, "cannot open file");
+MAKE_EXCEPTION(module_not_found_error, "module not found");
+
 #undef MAKE_EXCEPTION
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -289,9 +455,23 @@ struct s_string;
 struct s_function;
 struct s_array;
 
+struct function_template;
+
+struct expression;
+struct eval_context;
+struct call_site_cache;
+
+// list keyword handler number Ưȭ  node handlerԴϴ.
+using list_keyword_fn = variable (*)(const expression& expr, eval_context& context);
+using number_fn = double (*)(const expression& expr);
+
 template <typename T>
 using gc_vector = std::vector<T, traceable_allocator<T>>;
 
+// gc_allocator Ͱ  type GC  ʴ Ͽ Ҵմϴ.
+template <typename T>
+using gc_atomic_vector = std::vector<T, gc_allocator<T>>;
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /**
@@ -305,6 +485,9 @@ using gc_vector = std::vector<T, traceable_allocator<T>>;
 
 enum class expr_type { list, string, number, atom };
 
+// static type inference  expression  typeԴϴ.
+enum class static_type : std::uint8_t { dynamic, number, boolean };
+
 struct expression
 {
 	std::weak_ptr<expression> root;
@@ -316,71 +499,133 @@ struct expression
 		s_string* value;
 		double number;
 	};
+
+	// func expression ó 򰡵   function_templateԴϴ.
+	mutable std::shared_ptr<function_template> fn_template;
+
+	// list ó   ã handlerԴϴ. Ŀ keyword ٽ ã ʰ ٷ ȣմϴ.
+	mutable list_keyword_fn handler { nullptr };
+
+	// type feedback:    node operand  var_type bit Դϴ.
+	// quicken_threshold number ϸ handler number  ٲٰ, ƴ   ǵϴ.
+	//   node number_handler variable ġ ʰ double ٷ θ𿡰 ݴϴ.
+	mutable number_fn number_handler { nullptr };
+	mutable std::uint8_t feedback { 0 };
+	mutable std::uint16_t samples { 0 };
+	mutable std::uint16_t deopts { 0 };
+
+	// Լ  type inference  node  ׻ number boolean̶ ߴٸ  typeԴϴ.
+	//  operand    ٽ ˻ ʽϴ.
+	mutable static_type inferred { static_type::dynamic };
+
+	// Լ ȣ node ȣ Լ,  Լ inline Դϴ. ó ȣ  ϴ.
+	mutable std::shared_ptr<call_site_cache> call_cache;
+
+	// global  Ű atom node ã  global_object (cell)Դϴ.
+	// global_cell_epoch     ȿ ȿմϴ.
+	mutable std::pair<s_string* const, variable>* global_cell { nullptr };
+	mutable std::uint64_t global_cell_epoch { 0 };
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 
 /**
- * variable  ϳ ϴ üԴϴ.
- *  Ÿ boolean, number, undefined, object 4Դϴ.
- * boolean true/false Դϴ.
- * number 64Ʈ ε ҼԴϴ
- * undefined   Ÿϴ.
- * object  ŸԴϴ.
+ * flat hash table 
+ * Map dictionary mode object_map slot  迭 δ open addressing hash tableԴϴ.
+ * ctrl slot 1byte , ,  ִٸ key hash Ʒ 7bit ϴ.
+ * slot hash_group_width group ̰, key hash  bit ó  group մϴ.
+ * group ctrl   ؼ hash Ʒ 7bit  slot key մϴ. x86-64 SSE2 ϴ.
+ * group  slot  ã⸦ ,  1, 2, 3, ... group  ǳʶ group ϴ.
  **/
 
-enum class var_type { boolean, number, undefined, object };
-
-struct variable
+namespace
 {
-	var_type type;
-	union
-	{
-		bool v_boolean;
-		double v_number;
-		s_object* v_object;
-		std::uint64_t raw;
-	};
+	const std::size_t hash_group_width = 16;
 
-	bool operator ==(variable rhs)
+	// ų  slot ctrlԴϴ.  ִ slot ctrl 0 ~ 0x7F̹Ƿ   bit ˴ϴ.
+	const std::uint8_t ctrl_empty = 0x80;
+	const std::uint8_t ctrl_deleted = 0xFE;
+
+	//  Է hash Ʒ bit  bit ο   ϴ. (murmur3 fmix64)
+	std::uint64_t mix_hash(std::uint64_t h)
 	{
-		return (type == rhs.type && raw == rhs.raw);
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ULL;
+		h ^= h >> 33;
+		return h;
 	}
-	bool operator !=(variable rhs)
+
+	// group ctrl b slotԴϴ. i° bit group i° slotԴϴ.
+	std::uint32_t match_ctrl(const std::uint8_t* group, std::uint8_t b)
 	{
-		return !(*this == rhs);
+#ifdef LISCRIPT_SIMD
+		__m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+		__m128i eq = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(b)));
+		return static_cast<std::uint32_t>(_mm_movemask_epi8(eq));
+#else
+		std::uint32_t mask = 0;
+		for (std::size_t i = 0; i < hash_group_width; ++i)
+		{
+			if (group[i] == b)
+				mask |= 1u << i;
+		}
+		return mask;
+#endif
 	}
 
-	static variable boolean(bool b)
+	// group ų  slotԴϴ.
+	std::uint32_t match_free(const std::uint8_t* group)
 	{
-		variable ret;
-		ret.type = var_type::boolean;
-		ret.v_boolean = b;
-		return ret;
+#ifdef LISCRIPT_SIMD
+		__m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+		return static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl));
+#else
+		std::uint32_t mask = 0;
+		for (std::size_t i = 0; i < hash_group_width; ++i)
+		{
+			if (group[i] & 0x80)
+				mask |= 1u << i;
+		}
+		return mask;
+#endif
 	}
-	static variable number(double d)
+
+	std::size_t lowest_bit(std::uint32_t mask)
 	{
-		variable ret;
-		ret.type = var_type::number;
-		ret.v_number = d;
-		return ret;
+		std::size_t i = 0;
+		while ((mask & 1) == 0)
+		{
+			mask >>= 1;
+			++i;
+		}
+		return i;
 	}
-	static variable undefined()
+
+	// hash ʷ  groupԴϴ. group  2 ŵ̹Ƿ ᱹ  group   ϴ.
+	struct probe_seq
 	{
-		variable ret;
-		ret.type = var_type::undefined;
-		ret.raw = 0;
-		return ret;
-	}
-	static variable object(s_object* obj)
+		probe_seq(std::uint64_t hash, std::size_t capacity)
+			: mask(capacity / hash_group_width - 1), group(static_cast<std::size_t>(hash >> 7) & mask), stride(0) { }
+
+		std::size_t offset() const { return group * hash_group_width; }
+		void next()
+		{
+			++stride;
+			group = (group + stride) & mask;
+		}
+
+		std::size_t mask;
+		std::size_t group;
+		std::size_t stride;
+	};
+
+	std::uint8_t hash_tag(std::uint64_t hash)
 	{
-		variable ret;
-		ret.type = var_type::object;
-		ret.raw = 0;
-		ret.v_object = obj;
-		return ret;
+		return static_cast<std::uint8_t>(hash & 0x7F);
 	}
-};
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -391,7 +636,7 @@ struct variable
  * object proto    ֽϴ.     ϴ.
  * proto  object ̹Ƿ proto ϴ.
  * proto proto null ƴ϶ object  ̵    ֽϴ.
- * string, function, array object Ÿ Ư ޵˴ϴ.
+ * string, function, array, typed array, map, string builder object Ÿ Ư ޵˴ϴ.
  **/
 
 // hash & equal functor
@@ -404,12 +649,123 @@ struct pstr_equal
 	bool operator()(const s_string* str1, const s_string* str2) const;
 };
 
-// GC ۵ ؼ traceable_allocator Ҵ ޸𸮿  ؾ մϴ.
-using object_map_allocator = traceable_allocator<std::pair<s_string*, variable>>;
-using object_map = std::unordered_map<s_string*, variable,
-	pstr_hash, pstr_equal, object_map_allocator>;
+/**
+ * object_map object     [string, variable] hashmapԴϴ.
+ *  dictionary_threshold   node  unordered_map ϴ.
+ * ׺  dictionary mode ٲ,    chunk ̾ 
+ * flat hash table(flat hash table  ) slot  ȣ Ӵϴ.
+ * dictionary mode ٲ  ׶ ȸ  űǷ ȸ  ٲ ʰ,  ڷδ  Դϴ.
+ *   , dictionary mode ٲ       ּҰ ٲ ʽϴ.
+ * ٲ  global_cell_epoch ÷   global property cell  ϴ.
+ **/
+class object_map
+{
+public:
+	using key_type = s_string*;
+	using mapped_type = variable;
+	using value_type = std::pair<s_string* const, variable>;
+	using size_type = std::size_t;
+
+	static const std::size_t dictionary_threshold = 128;
 
-enum class object_type { object, string, function, array };
+private:
+	// GC ۵ ؼ traceable_allocator Ҵ ޸𸮿  ؾ մϴ.
+	using node_map = std::unordered_map<s_string*, variable, pstr_hash, pstr_equal, traceable_allocator<value_type>>;
+	struct dictionary;
+
+	static value_type& entry(const dictionary* dict, std::size_t index);
+
+public:
+	template <typename Value, typename NodeIt>
+	class basic_iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = object_map::value_type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Value*;
+		using reference = Value&;
+
+		basic_iterator() { }
+		basic_iterator(NodeIt node) : node_(node) { }
+		basic_iterator(const dictionary* dict, std::size_t index) : dict_(dict), index_(index) { }
+		template <typename V, typename N>
+		basic_iterator(const basic_iterator<V, N>& other) : node_(other.node_), dict_(other.dict_), index_(other.index_) { }
+
+		reference operator *() const { return dict_ != nullptr ? entry(dict_, index_) : *node_; }
+		pointer operator ->() const { return &**this; }
+
+		basic_iterator& operator ++()
+		{
+			if (dict_ != nullptr)
+				++index_;
+			else
+				++node_;
+			return *this;
+		}
+		basic_iterator operator ++(int)
+		{
+			basic_iterator ret = *this;
+			++*this;
+			return ret;
+		}
+
+		bool operator ==(const basic_iterator& rhs) const
+		{
+			return dict_ != nullptr ? index_ == rhs.index_ : node_ == rhs.node_;
+		}
+		bool operator !=(const basic_iterator& rhs) const
+		{
+			return !(*this == rhs);
+		}
+
+	private:
+		template <typename V, typename N>
+		friend class basic_iterator;
+
+		NodeIt node_;
+		const dictionary* dict_ { nullptr };
+		std::size_t index_ { 0 };
+	};
+
+	using iterator = basic_iterator<value_type, node_map::iterator>;
+	using const_iterator = basic_iterator<const value_type, node_map::const_iterator>;
+
+	object_map() { }
+	object_map(const object_map& other);
+	object_map(object_map&& other);
+	object_map& operator =(const object_map& other);
+	object_map& operator =(object_map&& other);
+	~object_map();
+
+	bool is_dictionary() const { return dict_ != nullptr; }
+	std::size_t size() const;
+	bool empty() const { return size() == 0; }
+
+	iterator begin();
+	iterator end();
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	iterator find(s_string* key);
+	const_iterator find(s_string* key) const;
+	std::pair<iterator, bool> insert(const value_type& value);
+	variable& operator [](s_string* key);
+
+	// count   rehash ʵ ̸ ϴ.
+	void reserve(std::size_t count);
+
+	//  map GC  ۿ  Ҵ ޸ ũ⸦ մϴ.
+	std::size_t heap_size() const;
+
+private:
+	void make_dictionary();
+
+	node_map nodes_;
+	dictionary* dict_ { nullptr };
+};
+
+enum class object_type { object, string, function, array, typed_array, record_array, record, map, string_builder };
 
 struct s_object
 {
@@ -427,42 +783,230 @@ struct s_string
 	const char* ptr;
 	size_t size;
 
+	// ó pstr_hash   hashԴϴ.   ʾҴٸ 0Դϴ.
+	mutable std::size_t hash;
+
+	// slice ptr Ű buffer  stringԴϴ. ̶ ptr[size] '\0' ƴ  ֽϴ.
+	// ڱ buffer  string̶ nullptrԴϴ.
+	s_string* base;
+
 	s_object* obj() { return &_obj; }
 	variable var() { return variable::object(obj()); }
 };
 inline std::size_t pstr_hash::operator()(const s_string* str) const
 {
-	return boost::hash_range(str->ptr, str->ptr + str->size);
+	if (str->hash == 0)
+	{
+		std::size_t hash = boost::hash_range(str->ptr, str->ptr + str->size);
+		str->hash = (hash != 0) ? hash : 1;
+	}
+	return str->hash;
 }
 inline bool pstr_equal::operator()(const s_string* str1, const s_string* str2) const
 {
-	return strcmp(str1->ptr, str2->ptr) == 0;
+	if (str1 == str2)
+		return true;
+	if (str1->size != str2->size || (str1->hash != 0 && str2->hash != 0 && str1->hash != str2->hash))
+		return false;
+	return std::memcmp(str1->ptr, str2->ptr, str1->size) == 0;
+}
+// slice ptr '\0'    Ƿ C ڿ ʿ  ؼ ϴ.
+inline std::string to_std_string(const s_string* str)
+{
+	return std::string(str->ptr, str->size);
 }
 
-using native_fn_t = variable (*)(variable this_var, s_array* arguments);
+// JIT ϵ Լ Դϴ.  ret  0, ܰ ߻ߴٸ 1 ȯմϴ.
+using jit_entry_t = int (*)(variable* ret);
 
-struct s_function
+// call site ȣ     ִ  native Լ Դϴ.
+enum class intrinsic_kind : std::uint8_t { none, array_size, array_get, array_set, typed_size, typed_get, typed_set };
+
+/**
+ * function_template Լ  ʴ κԴϴ.
+ * func expression   ,  expression   s_function մϴ.
+ *   ȿ func ص parameter  ٽ ų  ʽϴ.
+ **/
+
+struct function_template
 {
-	s_object _obj;
 	gc_vector<s_string*> parameters;
 	bool is_variadic;
 
+	// Լ  arguments Ű带 ؼ arguments 迭 ȣ    ִ 
+	bool arguments_escape;
+
 	bool is_native;
 	union
 	{
 		const expression* expr;
 		native_fn_t native_fn;
 	};
+
+	// native_fn   call site    ִ  Լ  Դϴ.
+	intrinsic_kind intrinsic;
+
+	// call_function() while ȣ Ƚ back-edge Ƚ  tier øϴ. (   )
+	// type guard jit_deopt_limit ϸ jit_entry  ٽ interpreter մϴ.
+	// this а ۿ  native Լ,  this   ٲ    ö󰡴 epochԴϴ.
+	// loop site   ״    ȣ  ٽ ,   Լ nullptrԴϴ.
+	const std::uint64_t* result_epoch;
+
+	mutable std::uint32_t call_count;
+	mutable std::uint32_t backedge_count;
+	mutable std::uint8_t tier;
+	mutable std::uint32_t jit_deopts;
+	mutable bool jit_failed;
+	mutable jit_entry_t jit_entry;
+	mutable std::unique_ptr<jitmem::block> jit_code;
+};
+
+struct s_function
+{
+	s_object _obj;
+	const function_template* templ;
+
+	// templ expr ִ expression tree Ӵϴ.
 	std::shared_ptr<expression> expr_root;
 
+	// slack tracking: ڷ   ó slack_tracking_count   object field  մϴ.
+	//   new ϵ ŭ vars ̸ Ƽ field   rehash ʵ մϴ.
+	static const std::uint32_t slack_tracking_count = 8;
+	static const std::uint32_t slack_tracking_limit = 64;
+	std::uint32_t ctor_count;
+	std::uint32_t ctor_fields;
+
 	s_object* obj() { return &_obj; }
 	variable var() { return variable::object(obj()); }
 };
 
+/**
+ * elements_kind s_array ׸  Դϴ.
+ * packed_int int32, packed_double double ׸ ̾ , generic variable ϴ.
+ *  ʴ  ó  packed_int -> packed_double -> generic    ٲ ǵư ʽϴ.
+ * ũƮ  迭 packed_int ϰ, arguments 迭 native  迭 genericԴϴ.
+ **/
+enum class elements_kind : std::uint8_t { packed_int, packed_double, generic };
+
+// script   û  ִ 迭  Դϴ. ̺ ũ out_of_range_error ߻մϴ.
+const std::size_t max_array_length = INT32_MAX;
+
 struct s_array
 {
 	s_object _obj;
+	elements_kind kind;
+
+	// generic 迭 ׸Դϴ. packed 迭̸  ֽϴ.
 	gc_vector<variable> vector;
+	gc_atomic_vector<std::int32_t> ints;
+	gc_atomic_vector<double> doubles;
+
+	// GC  ƴ ȣ  stack  arguments 迭 
+	bool frame_local;
+
+	std::size_t size() const;
+	variable get(std::size_t i) const;
+	void set(std::size_t i, variable v);
+	void push_back(variable v);
+	void pop_back();
+	// ޸𸮰 ڶ out_of_range_error ߻մϴ.
+	void reserve(std::size_t capacity);
+
+	// ׸   items äϴ. kind о⸸ մϴ.
+	void assign(const variable* items, std::size_t count);
+	// src [begin, end) ׸  Դϴ.
+	void append(const s_array* src, std::size_t begin, std::size_t end);
+	// v   ֵ kind ϴ.
+	void widen(elements_kind to);
+
+	s_object* obj() { return &_obj; }
+	variable var() { return variable::object(obj()); }
+};
+
+// typed array ׸ typeԴϴ.
+enum class element_type : std::uint8_t { float64, int32 };
+
+// number    迭Դϴ.
+// ׸񿡴 Ͱ Ƿ GC  ʴ Ͽ variable   Դϴ.
+struct s_typed_array
+{
+	s_object _obj;
+	element_type element;
+	std::size_t size;
+
+	// base GC_MALLOC_ATOMIC  ̰, data  ȿ simd_alignment  ּԴϴ.
+	void* base;
+	void* data;
+
+	double* f64() { return static_cast<double*>(data); }
+	std::int32_t* i32() { return static_cast<std::int32_t*>(data); }
+
+	s_object* obj() { return &_obj; }
+	variable var() { return variable::object(obj()); }
+};
+
+//  ڷ  object field ϳ Array column   迭Դϴ.
+//  field column packed 迭 ǹǷ  field  ޸𸮸 ʷ нϴ.
+struct s_record_array
+{
+	s_object _obj;
+
+	// ׸ proxy prototypeԴϴ.
+	s_object* record_proto;
+	gc_vector<s_string*> fields;
+	gc_vector<s_array*> columns;
+	std::size_t size;
+
+	s_object* obj() { return &_obj; }
+	variable var() { return variable::object(obj()); }
+};
+
+// s_record_array index° ׸ Ű proxyԴϴ.
+// getf, setf column  а , method record_proto ãϴ.
+struct s_record
+{
+	s_object _obj;
+	s_record_array* owner;
+	std::size_t index;
+
+	s_object* obj() { return &_obj; }
+	variable var() { return variable::object(obj()); }
+};
+
+/**
+ * s_map ƹ variable̳ key  hash tableԴϴ. (Map hash table )
+ * slot  迭 ΰ open addressing ãǷ ׸񸶴 node Ҵ ʽϴ.
+ * ctrl slot 1byte , ,  ִٸ key hash Ʒ 7bit ϴ.
+ **/
+struct map_slot
+{
+	variable key;
+	variable value;
+};
+
+struct s_map
+{
+	s_object _obj;
+	gc_atomic_vector<std::uint8_t> ctrl;
+	gc_vector<map_slot> slots;
+	std::size_t size;
+	// ٰ ǥõ slot Դϴ. ٽ äų rehash  ã⸦ ߰  ʽϴ.
+	std::size_t deleted;
+
+	s_object* obj() { return &_obj; }
+	variable var() { return variable::object(obj()); }
+};
+
+/**
+ * s_string_builder append ڸ  buffer Ƶΰ toString    s_string մϴ.
+ * string ϳ ̾    string  Ͱ ޸ ü ̿ ϴ ð ɸϴ.
+ **/
+struct s_string_builder
+{
+	s_object _obj;
+	gc_atomic_vector<char> buffer;
+	//  toString Դϴ.  ڷ  ٲ nullptrԴϴ.
+	s_string* flat;
 
 	s_object* obj() { return &_obj; }
 	variable var() { return variable::object(obj()); }
@@ -486,1951 +1030,9091 @@ s_object* p_Object;
 s_object* p_Function;
 s_object* p_String;
 s_object* p_Array;
+s_object* p_Float64Array;
+s_object* p_Int32Array;
+s_object* p_RecordArray;
+s_object* p_Map;
+s_object* p_StringBuilder;
 
 // Object, Function, String, Array constructor
 s_object* f_Object;
 s_object* f_Function;
 s_object* f_String;
 s_object* f_Array;
+s_object* f_Float64Array;
+s_object* f_Int32Array;
+s_object* f_RecordArray;
+s_object* f_Map;
+s_object* f_StringBuilder;
 
 // some cached strings initialized by init_scripting()
 s_string* str_empty; // ""
 s_string* str_prototype; // "prototype"
 s_string* str_replconfig; // "replConfig"
 s_string* str_dumpexpr; // "dumpExpr"
+s_string* str_profilealloc; // "profileAlloc"
+s_string* str_tierlog; // "tierLog"
+s_string* str_warmthreshold; // "warmThreshold"
+s_string* str_jitthreshold; // "jitThreshold"
 
-////////////////////////////////////////////////////////////////////////////////
+// object  ٲ  ö󰩴ϴ. loop site     method lookup Ȯմϴ.
+std::uint64_t shape_epoch = 0;
+// array ̰ ٲ  ö󰩴ϴ. Array size      ٲ ʽϴ.
+// s_array push_back, pop_back, assign, append øǷ ̸ ٲٴ   Լ ľ մϴ.
+std::uint64_t array_length_epoch = 0;
 
 /**
- *  ִ stackframeԴϴ.
- * frame_entry Լ  frameԴϴ.
- * frame_entry  blocks   frameԴϴ.
+ * global property cell
+ * stackframe Լ parameter, Լ ȿ ó setl ̸ Դϴ.
+ * ׷ ̸ frame_names  ΰ,   ̸ atom stackframe ã ʰ ٷ global ãϴ.
+ * ã  unordered_map node̹Ƿ  ʴ  ּҰ ٲ ʽϴ. atom node ̸ cell մϴ.
+ * frame_names  ̸ ų(shadowing) global_object   (proto  )
+ * global_cell_epoch ö󰡰   cell  ٽ ãϴ.
  **/
+std::uint64_t global_cell_epoch = 1;
+std::unordered_set<s_string*, pstr_hash, pstr_equal, traceable_allocator<s_string*>> frame_names;
 
-struct frame_entry
+inline void register_frame_name(s_string* name)
 {
-	s_array* arguments;
-	variable this_var;
-	std::list<object_map> blocks;
-};
-
-std::list<frame_entry> stackframe;
-
-////////////////////////////////////////////////////////////////////////////////
+	if (frame_names.insert(name).second)
+		++global_cell_epoch;
+}
 
 /**
- * object, string, function Ҵ/ ԼԴϴ.
- * allocate Լ GC Ҵ ʱȭ մϴ.
- * create Լ allocate ȣ  proto, name  մϴ.
+ * intern table
+ * script atom,   ̸, AOT module ̸ 븶 ϳ s_string ϴ.
+ * string literal  ̹Ƿ intern ʽϴ. string  񱳴  object Դϴ.
+ *  ߿  string geti, seti ϸ   table   s_string ã װ  ãϴ.
+ * ׷ object_map  񱳸  ã, hash s_string   ˴ϴ.
+ * table  string  Ƿ,  ߿  ̸     table  ʽϴ.
+ * ׷  object_map  ϹǷ ã  ֽϴ.
  **/
+std::unordered_set<s_string*, pstr_hash, pstr_equal, traceable_allocator<s_string*>> intern_table;
 
-s_object* allocate_object();
-s_object* create_object();
-
-s_string* allocate_string(const std::string& str);
-s_string* create_string(const std::string& str);
+// slice    string, ƴ϶ str ״ ȯմϴ.
+s_string* own_string(s_string* str);
 
-s_function* allocate_function(const gc_vector<s_string*>& parameters, const expression& expr, bool is_variadic = false);
-s_function* create_function(const gc_vector<s_string*>& parameters, const expression& expr, bool is_variadic = false);
-
-s_function* allocate_native_function(const gc_vector<s_string*>& parameters, native_fn_t native_fn, bool is_variadic = false);
-s_function* create_native_function(const gc_vector<s_string*>& parameters, native_fn_t native_fn, bool is_variadic = false);
+// str   interned string ȯմϴ. ٸ str ְ str ȯմϴ.
+// slice parent   ʵ 纻 ְ װ ȯմϴ.
+inline s_string* intern_string(s_string* str)
+{
+	auto it = intern_table.find(str);
+	if (it != intern_table.end())
+		return *it;
+	str = own_string(str);
+	intern_table.insert(str);
+	return str;
+}
 
-s_array* allocate_array();
-s_array* create_array();
+// str   interned string ȯմϴ. ٸ table ٲ ʰ str ȯմϴ.
+inline s_string* find_interned(s_string* str)
+{
+	auto it = intern_table.find(str);
+	return it != intern_table.end() ? *it : str;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
 /**
- * ʱȭ, expr м, expr 
+ * object_map dictionary mode
+ *  chunk_size chunk ϴ. chunk ű Ƿ chunk þ  ּҴ ״Դϴ.
+ * slot  ȣ ΰ,  ִ slot 7/8  slot group 迭 ٽ ϴ.
+ * chunk slot group 迭 object (stackframe block ) ִ map ֵ traceable_allocator Ҵմϴ.
  **/
 
-void init_scripting();
-
-bool read_expr(std::istream& strm, expression& ret, const std::weak_ptr<expression>& root);
-
-// Ǻδ eval_expr() ٷ ʿ
-struct eval_context;
-variable eval_expr(const expression& expr);
-
-bool to_conditional(variable var);
-std::int64_t to_integer(double n);
-
-boost::optional<object_map::iterator> find_member(s_object* obj, s_string* name);
-boost::optional<object_map::iterator> find_local(s_string* name);
-
-variable call_function(s_function* fn, variable new_this, s_array* arguments);
+struct object_map::dictionary
+{
+	static const std::size_t chunk_shift = 8;
+	static const std::size_t chunk_size = std::size_t(1) << chunk_shift;
 
-////////////////////////////////////////////////////////////////////////////////
+	//  group ctrl  ȣ ٿ ξ ã  д cache line Դϴ.
+	struct slot_group
+	{
+		std::uint8_t ctrl[hash_group_width];
+		std::uint32_t index[hash_group_width];
+	};
 
-/**
- *  Լ
- **/
+	gc_vector<value_type*> chunks;
+	std::vector<slot_group, traceable_allocator<slot_group>> groups;
+	std::size_t size { 0 };
 
-void print_var(std::ostream& strm, variable var, int indent = 0);
-void dump_expr(const expression& expr, int indent = 0);
+	dictionary() { }
+	dictionary(const dictionary&) = delete;
+	dictionary& operator =(const dictionary&) = delete;
 
-////////////////////////////////////////////////////////////////////////////////
+	~dictionary()
+	{
+		for (value_type* chunk : chunks)
+			traceable_allocator<value_type>().deallocate(chunk, chunk_size);
+	}
 
-// Read-Eval-Print-Loop  boost.iostream sourceԴϴ.
-class repl_source
-{
-public:
-	typedef char char_type;
-	typedef io::source_tag category;
+	static dictionary* create()
+	{
+		dictionary* dict = traceable_allocator<dictionary>().allocate(1);
+		return new (dict) dictionary();
+	}
 
-	std::streamsize read(char* s, std::streamsize n)
+	static void destroy(dictionary* dict)
 	{
-		int ch = getc();
-		if (ch == -1)
-			return -1;
+		if (dict == nullptr)
+			return;
+		dict->~dictionary();
+		traceable_allocator<dictionary>().deallocate(dict, 1);
+	}
 
-		*s = (char)ch;
-		return 1;
+	value_type& at(std::size_t index) const
+	{
+		return chunks[index >> chunk_shift][index & (chunk_size - 1)];
 	}
 
-	void reset_prompt()
+	static std::uint64_t hash_of(s_string* key)
 	{
-		first_newline_ = true;
+		return mix_hash(pstr_hash()(key));
 	}
 
-	void clear()
+	// key   ȣԴϴ.  sizeԴϴ.
+	std::size_t find(s_string* key) const
 	{
-		line_.clear();
-		idx_ = 1;
+		if (groups.empty())
+			return size;
+
+		std::uint64_t hash = hash_of(key);
+		std::uint8_t tag = hash_tag(hash);
+		for (probe_seq seq(hash, groups.size() * hash_group_width); ; seq.next())
+		{
+			const slot_group& group = groups[seq.group];
+			for (std::uint32_t m = match_ctrl(group.ctrl, tag); m != 0; m &= m - 1)
+			{
+				std::uint32_t index = group.index[lowest_bit(m)];
+				s_string* name = at(index).first;
+				if (name == key || pstr_equal()(name, key))
+					return index;
+			}
+			if (match_ctrl(group.ctrl, ctrl_empty) != 0)
+				return size;
+		}
 	}
 
-private:
-	int getc()
+	void place(std::uint32_t index, std::uint64_t hash)
 	{
-		if (idx_ > line_.size())
+		for (probe_seq seq(hash, groups.size() * hash_group_width); ; seq.next())
 		{
-			if (first_newline_)
+			slot_group& group = groups[seq.group];
+			std::uint32_t m = match_ctrl(group.ctrl, ctrl_empty);
+			if (m != 0)
 			{
-				std::cout << ">> ";
-				first_newline_ = false;
+				std::size_t i = lowest_bit(m);
+				group.ctrl[i] = hash_tag(hash);
+				group.index[i] = index;
+				return;
 			}
-			else
-			{
-				std::cout << "-- ";
-			}
-
-			getline(std::cin, line_);
-			idx_ = 0;
-
-			if (std::cin.eof())
-				return -1;
 		}
+	}
 
-		if (idx_ == line_.size())
-		{
-			++idx_;
-			return '\n';
-		}
-		else
-		{
-			return line_[idx_++];
-		}
+	//  count ־  7/16  ũ slot 迭 ٽ ϴ.
+	void rehash(std::size_t count)
+	{
+		std::size_t capacity = hash_group_width;
+		while (count * 16 > capacity * 7)
+			capacity *= 2;
+		if (capacity <= groups.size() * hash_group_width)
+			return;
+
+		slot_group empty;
+		std::fill(std::begin(empty.ctrl), std::end(empty.ctrl), ctrl_empty);
+		std::fill(std::begin(empty.index), std::end(empty.index), 0);
+		groups.assign(capacity / hash_group_width, empty);
+		for (std::size_t i = 0; i < size; ++i)
+			place(static_cast<std::uint32_t>(i), hash_of(at(i).first));
 	}
 
-	std::string line_;
-	std::string::size_type idx_ { 1 };
-	bool first_newline_ { true };
+	// key ٴ  Ȯ ڿ θϴ.
+	std::size_t append(const value_type& value)
+	{
+		// slot  ȣ uint32 Ӵϴ.
+		if (size >= std::numeric_limits<std::uint32_t>::max())
+			throw out_of_range_error();
+		if ((size + 1) * 8 > groups.size() * hash_group_width * 7)
+			rehash(size + 1);
+		if ((size >> chunk_shift) == chunks.size())
+			chunks.push_back(traceable_allocator<value_type>().allocate(chunk_size));
+
+		std::size_t index = size;
+		new (&at(index)) value_type(value);
+		++size;
+		place(static_cast<std::uint32_t>(index), hash_of(value.first));
+		return index;
+	}
 };
 
-////////////////////////////////////////////////////////////////////////////////
-
-int main()
+inline object_map::value_type& object_map::entry(const dictionary* dict, std::size_t index)
 {
-	io::stream<repl_source> strm;
-	strm.open(repl_source { });
-
-	init_scripting();
+	return dict->at(index);
+}
 
-	while (true)
+object_map::object_map(const object_map& other)
+	: nodes_(other.nodes_)
+{
+	if (other.dict_ != nullptr)
 	{
-		auto expr = std::make_shared<expression>();
-		std::weak_ptr<expression> w_expr = expr;
-
-		strm->reset_prompt();
-		try
-		{
-			if (read_expr(strm, *expr, w_expr))
-			{
-				int ch = io::get(strm);
-				if (ch != -1 && ch != '\n')
-				{
-					strm->clear();
-					throw unexpected_character_error();
-				}
-
-				try
-				{
-					auto it = replconfig_object->vars.find(str_dumpexpr);
-					if (it != replconfig_object->vars.end() && to_conditional(it->second))
-					{
-						conlib::setcolor_block scb(conlib::color::darkgreen);
-						dump_expr(*expr);
-					}
-				}
-				catch (invalid_conditional&) { }
-
-				variable var = eval_expr(*expr);
-
-				print_var(std::cout, var);
-				std::cout << std::endl;
-			}
-			else if (strm.eof())
-			{
-				break;
-			}
-		}
-		catch (std::runtime_error& ex)
-		{
-			conlib::setcolor_block scb(conlib::color::red);
-			std::cerr << ex.what() << std::endl;
-		}
+		dict_ = dictionary::create();
+		dict_->rehash(other.dict_->size);
+		for (const value_type& pr : other)
+			dict_->append(pr);
 	}
 }
 
-////////////////////////////////////////////////////////////////////////////////
-
-s_object* allocate_object()
+object_map::object_map(object_map&& other)
+	: nodes_(std::move(other.nodes_)), dict_(other.dict_)
 {
-	s_object* obj = (s_object*)GC_MALLOC(sizeof(s_object));
-	new (obj) s_object();
-
-	obj->type = object_type::object;
+	other.dict_ = nullptr;
+}
 
-	GC_REGISTER_FINALIZER(obj, [](void* r_obj, void* cdata)
+object_map& object_map::operator =(const object_map& other)
+{
+	if (this != &other)
 	{
-		delete (s_object*)r_obj;
-	}, nullptr, nullptr, nullptr);
-
-	return obj;
+		object_map tmp(other);
+		*this = std::move(tmp);
+	}
+	return *this;
 }
 
-s_object* create_object()
+object_map& object_map::operator =(object_map&& other)
 {
-	s_object* obj = allocate_object();
-	obj->proto = p_Object;
-	obj->name = str_empty;
-	return obj;
+	if (this != &other)
+	{
+		dictionary::destroy(dict_);
+		nodes_ = std::move(other.nodes_);
+		dict_ = other.dict_;
+		other.dict_ = nullptr;
+	}
+	return *this;
 }
 
-s_string* allocate_string(const std::string& str)
+object_map::~object_map()
 {
-	s_string* obj = (s_string*)GC_MALLOC(sizeof(s_string) + str.size() + 1);
-	new (obj) s_string();
-
-	obj->_obj.type = object_type::string;
-	obj->ptr = (char*)obj + sizeof(s_string);
-	obj->size = str.size();
-	std::memcpy((char*)obj->ptr, str.c_str(), str.size() + 1);
-
-	GC_REGISTER_FINALIZER(obj, [](void* r_obj, void* cdata) {
-		delete (s_string*)r_obj;
-	}, nullptr, nullptr, nullptr);
-
-	return obj;
+	dictionary::destroy(dict_);
 }
 
-s_string* create_string(const std::string& str)
+std::size_t object_map::size() const
 {
-	if (str.empty())
-		return str_empty;
-
-	s_string* obj = allocate_string(str);
-	obj->_obj.proto = p_String;
-	obj->_obj.name = str_empty;
-	return obj;
+	return dict_ != nullptr ? dict_->size : nodes_.size();
 }
 
-s_function* allocate_function(const gc_vector<s_string*>& parameters, const expression& expr, bool is_variadic /* = false */)
+object_map::iterator object_map::begin()
 {
-	s_function* obj = (s_function*)GC_MALLOC(sizeof(s_function));
-	new (obj) s_function();
+	return dict_ != nullptr ? iterator(dict_, 0) : iterator(nodes_.begin());
+}
 
-	obj->_obj.type = object_type::function;
-	obj->parameters = parameters;
-	obj->is_variadic = is_variadic;
-	obj->is_native = false;
-	obj->expr = &expr;
-	obj->expr_root = expr.root.lock();
+object_map::iterator object_map::end()
+{
+	return dict_ != nullptr ? iterator(dict_, dict_->size) : iterator(nodes_.end());
+}
 
-	GC_REGISTER_FINALIZER(obj, [](void* r_obj, void* cdata) {
-		delete (s_function*)r_obj;
-	}, nullptr, nullptr, nullptr);
+object_map::const_iterator object_map::begin() const
+{
+	return dict_ != nullptr ? const_iterator(dict_, 0) : const_iterator(nodes_.begin());
+}
 
-	return obj;
+object_map::const_iterator object_map::end() const
+{
+	return dict_ != nullptr ? const_iterator(dict_, dict_->size) : const_iterator(nodes_.end());
 }
 
-s_function* create_function(const gc_vector<s_string*>& parameters, const expression& expr, bool is_variadic /* = false */)
+object_map::iterator object_map::find(s_string* key)
 {
-	s_function* obj = allocate_function(parameters, expr, is_variadic);
-	obj->_obj.proto = p_Function;
-	obj->_obj.name = str_empty;
-	return obj;
+	return dict_ != nullptr ? iterator(dict_, dict_->find(key)) : iterator(nodes_.find(key));
 }
 
-s_function* allocate_native_function(const gc_vector<s_string*>& parameters, native_fn_t native_fn, bool is_variadic /* = false */)
+object_map::const_iterator object_map::find(s_string* key) const
 {
-	s_function* obj = (s_function*)GC_MALLOC(sizeof(s_function));
-	new (obj) s_function();
+	return dict_ != nullptr ? const_iterator(dict_, dict_->find(key)) : const_iterator(nodes_.find(key));
+}
 
-	obj->_obj.type = object_type::function;
-	obj->parameters = parameters;
-	obj->is_variadic = is_variadic;
-	obj->is_native = true;
-	obj->native_fn = native_fn;
+std::pair<object_map::iterator, bool> object_map::insert(const value_type& value)
+{
+	if (dict_ == nullptr && nodes_.size() >= dictionary_threshold && nodes_.find(value.first) == nodes_.end())
+		make_dictionary();
 
-	GC_REGISTER_FINALIZER(obj, [](void* r_obj, void* cdata) {
-		delete (s_function*)r_obj;
-	}, nullptr, nullptr, nullptr);
+	if (dict_ == nullptr)
+	{
+		auto res = nodes_.insert(value);
+		return { iterator(res.first), res.second };
+	}
 
-	return obj;
+	std::size_t index = dict_->find(value.first);
+	if (index != dict_->size)
+		return { iterator(dict_, index), false };
+	return { iterator(dict_, dict_->append(value)), true };
 }
 
-s_function* create_native_function(const gc_vector<s_string*>& parameters, native_fn_t native_fn, bool is_variadic /* = false */)
+variable& object_map::operator [](s_string* key)
 {
-	s_function* obj = allocate_native_function(parameters, native_fn, is_variadic);
-	obj->_obj.proto = p_Function;
-	obj->_obj.name = str_empty;
-	return obj;
+	return insert({ key, variable::undefined() }).first->second;
 }
 
-s_array* allocate_array()
+void object_map::reserve(std::size_t count)
 {
-	s_array* obj = (s_array*)GC_MALLOC(sizeof(s_array));
-	new (obj) s_array();
+	if (dict_ == nullptr && count > dictionary_threshold)
+		make_dictionary();
 
-	obj->_obj.type = object_type::array;
+	if (dict_ != nullptr)
+		dict_->rehash(count);
+	else
+		nodes_.reserve(count);
+}
 
-	GC_REGISTER_FINALIZER(obj, [](void* r_obj, void* cdata) {
-		delete (s_array*)r_obj;
-	}, nullptr, nullptr, nullptr);
+std::size_t object_map::heap_size() const
+{
+	if (dict_ != nullptr)
+	{
+		return sizeof(dictionary) + dict_->chunks.capacity() * sizeof(value_type*)
+			+ dict_->chunks.size() * dictionary::chunk_size * sizeof(value_type)
+			+ dict_->groups.size() * sizeof(dictionary::slot_group);
+	}
 
-	return obj;
+	// bucket 迭 node ϳ next , hash  մϴ.
+	return nodes_.bucket_count() * sizeof(void*)
+		+ nodes_.size() * (sizeof(value_type) + sizeof(void*) + sizeof(std::size_t));
 }
 
-s_array* create_array()
+void object_map::make_dictionary()
 {
-	s_array* obj = allocate_array();
-	obj->_obj.proto = p_Array;
-	obj->_obj.name = str_empty;
-	return obj;
+	dictionary* dict = dictionary::create();
+	dict->rehash(nodes_.size() + 1);
+	for (const value_type& pr : nodes_)
+		dict->append(pr);
+
+	node_map().swap(nodes_);
+	dict_ = dict;
+	++global_cell_epoch;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void init_scripting()
+/**
+ *  ִ stackframeԴϴ.
+ * frame_entry Լ  frameԴϴ.
+ * frame_entry  blocks   frameԴϴ.
+ **/
+
+struct frame_entry
 {
-	GC_INIT();
-	GC_set_finalize_on_demand(0/*false*/);
+	s_function* function;
+	s_array* arguments;
+	variable this_var;
+	std::list<object_map> blocks;
+};
 
-	empty_expr.type = expr_type::list;
+std::list<frame_entry> stackframe;
 
-	// prototype objects
-	p_Object = allocate_object();
-	p_Object->proto = nullptr;
+////////////////////////////////////////////////////////////////////////////////
 
-	p_Function = allocate_object();
-	p_Function->proto = p_Object;
+/**
+ * object, string, function Ҵ/ ԼԴϴ.
+ * allocate Լ GC Ҵ ʱȭ մϴ.
+ * create Լ allocate ȣ  proto, name  մϴ.
+ **/
 
-	p_String = allocate_object();
-	p_String->proto = p_Object;
+s_object* allocate_object();
+s_object* create_object();
 
-	p_Array = allocate_object();
-	p_Array->proto = p_Object;
+s_string* allocate_string(const std::string& str);
+s_string* allocate_string(const char* ptr, std::size_t size);
+s_string* create_string(const std::string& str);
+s_string* create_string(const char* ptr, std::size_t size);
 
-	// cached strings
-	str_empty = allocate_string("");
-	str_empty->_obj.proto = p_String;
+// parent offset° byte size byte  ʰ Ű string ϴ.
+s_string* create_slice(s_string* parent, std::size_t offset, std::size_t size);
 
-	s_string* str_object = create_string("Object");
-	s_string* str_function = create_string("Function");
-	s_string* str_string = create_string("String");
-	s_string* str_array = create_string("Array");
-	s_string* str_index = create_string("index");
-	s_string* str_val = create_string("val");
-	s_string* str_str = create_string("str");
-	str_prototype = create_string("prototype");
-	str_replconfig = create_string("replConfig");
-	str_dumpexpr = create_string("dumpExpr");
+std::shared_ptr<function_template> make_function_template(const gc_vector<s_string*>& parameters, const expression& expr, bool is_variadic = false);
+std::shared_ptr<function_template> make_native_template(const gc_vector<s_string*>& parameters, native_fn_t native_fn, bool is_variadic = false);
 
-	p_Object->name = str_object;
-	p_Function->name = str_function;
-	p_String->name = str_string;
-	p_Array->name = str_array;
+s_function* allocate_function(const function_template* templ, std::shared_ptr<expression> expr_root);
+s_function* create_function(const function_template* templ, std::shared_ptr<expression> expr_root);
 
-	// constructor objects
-	f_Object = create_function({ }, empty_expr)->obj();
-	f_Object->vars[str_prototype] = variable::object(p_Object);
+// native Լ template α׷   ˴ϴ.
+s_function* create_native_function(const gc_vector<s_string*>& parameters, native_fn_t native_fn, bool is_variadic = false,
+	const std::uint64_t* result_epoch = nullptr, intrinsic_kind intrinsic = intrinsic_kind::none);
 
-	f_Function = create_function({ }, empty_expr)->obj();
-	f_Function->vars[str_prototype] = variable::object(p_Function);
+s_array* allocate_array();
+s_array* create_array(elements_kind kind = elements_kind::generic);
 
-	f_String = create_function({ }, empty_expr)->obj();
-	f_String->vars[str_prototype] = variable::object(p_String);
+//  ׸ 0 size  typed array ϴ.
+s_typed_array* allocate_typed_array(element_type element, std::size_t size);
+s_typed_array* create_typed_array(element_type element, std::size_t size);
 
-	f_Array = create_function({ }, empty_expr)->obj();
-	f_Array->vars[str_prototype] = variable::object(p_Array);
+// record_proto ׸ fields column   record array ϴ.
+s_record_array* create_record_array(s_object* record_proto, const gc_vector<s_string*>& fields);
+s_record* create_record(s_record_array* owner, std::size_t index);
 
-	// array
-	native_fn_t array_size = [](variable this_var, s_array* arguments) {
-		if (this_var.type != var_type::object)
-			throw not_array_error();
-		if (this_var.v_object == nullptr)
-			throw null_reference_error();
-		if (this_var.v_object->type != object_type::array)
-			throw not_array_error();
-		s_array* arr = (s_array*)this_var.v_object;
+//  Map ϴ. new Map ȣմϴ.
+s_map* create_map();
 
-		if (arguments->vector.size() != 0)
-			throw invalid_arg_error();
+//  StringBuilder ϴ. new StringBuilder ȣմϴ.
+s_string_builder* create_string_builder();
 
-		return variable::number(arr->vector.size());
-	};
-	native_fn_t array_get = [](variable this_var, s_array* arguments) {
-		if (this_var.type != var_type::object)
-			throw not_array_error();
-		if (this_var.v_object == nullptr)
-			throw null_reference_error();
-		if (this_var.v_object->type != object_type::array)
-			throw not_array_error();
-		s_array* arr = (s_array*)this_var.v_object;
+void init_frame_local_array(s_array& arr);
+s_array* promote_array(s_array* arr);
 
-		if (arguments->vector.size() != 1)
-			throw invalid_arg_error();
-		if (arguments->vector[0].type != var_type::number)
-			throw invalid_arg_error();
-		try
-		{
-			std::size_t idx = static_cast<std::size_t>(to_integer(arguments->vector[0].v_number));
-			if (idx >= arr->vector.size())
-				throw out_of_range_error();
-			return arr->vector[idx];
-		}
-		catch (not_integer_error&)
-		{
-			throw invalid_arg_error();
-		}
-	};
-	native_fn_t array_set = [](variable this_var, s_array* arguments) {
-		if (this_var.type != var_type::object)
-			throw not_array_error();
-		if (this_var.v_object == nullptr)
-			throw null_reference_error();
-		if (this_var.v_object->type != object_type::array)
-			throw not_array_error();
-		s_array* arr = (s_array*)this_var.v_object;
+////////////////////////////////////////////////////////////////////////////////
 
-		if (arguments->vector.size() != 2)
-			throw invalid_arg_error();
-		if (arguments->vector[0].type != var_type::number)
-			throw invalid_arg_error();
-		try
-		{
-			std::size_t idx = static_cast<std::size_t>(to_integer(arguments->vector[0].v_number));
-			if (idx >= arr->vector.size())
-				throw out_of_range_error();
-			return (arr->vector[idx] = arguments->vector[1]);
-		}
-		catch (not_integer_error&)
-		{
-			throw invalid_arg_error();
-		}
-	};
-	p_Array->vars[create_string("size")] = create_native_function({ }, array_size)->var();
-	p_Array->vars[create_string("get")] = create_native_function({ str_index }, array_get)->var();
-	p_Array->vars[create_string("set")] = create_native_function({ str_index, str_val }, array_set)->var();
+/**
+ * ʱȭ, expr м, expr 
+ **/
 
-	// register constructors into global object
-	global_object = create_object();
-	global_object->vars[str_object] = variable::object(f_Object);
-	global_object->vars[str_function] = variable::object(f_Function);
-	global_object->vars[str_string] = variable::object(f_String);
-	global_object->vars[str_array] = variable::object(f_Array);
+void init_scripting();
 
-	// predefined variables
-	this_var = variable::object(global_object);
-	prev_var = variable::undefined();
+bool read_expr(std::istream& strm, expression& ret, const std::weak_ptr<expression>& root);
 
-	// repl
-	replconfig_object = create_object();
-	replconfig_object->vars[str_dumpexpr] = variable::boolean(false);
-	global_object->vars[str_replconfig] = variable::object(replconfig_object);
+/**
+ *  
+ * read_expr()  expression operand  literal , bit, , and/or/not  ̸ 
+ * literal ٲٰ,  literal if õǴ branch ٲߴϴ.
+ * literal number true, false, null, undefinedԴϴ.
+ * ϴ ܰ    NaN  ״ ξ      մϴ.
+ **/
+void fold_constants(expression& expr);
 
-	// console
-	native_fn_t console_dump = [](variable this_var, s_array* arguments) {
-		for (variable var : arguments->vector)
-		{
-			print_var(std::cout, var);
-			std::cout << std::endl;
-		}
-		return variable::undefined();
-	};
-	native_fn_t console_readline = [](variable this_var, s_array* arguments) {
-		std::string line;
-		getline(std::cin, line);
-		return create_string(line)->var();
-	};
-	console_object = create_object();
-	console_object->vars[create_string("dump")] = create_native_function({ }, console_dump, true)->var();
-	console_object->vars[create_string("readLine")] = create_native_function({ }, console_readline)->var();
-	global_object->vars[create_string("console")] = variable::object(console_object);
+// read_expr()  expression ȭ pass ʷ մϴ.
+void optimize_expr(expression& expr);
 
-	// global functions
-	native_fn_t fn_parseFloat = [](variable this_var, s_array* arguments) {
-		if (arguments->vector.size() != 1)
-			throw invalid_arg_error();
-		if (arguments->vector[0].type != var_type::object)
-			throw invalid_arg_error();
-		if (arguments->vector[0].v_object == nullptr)
-			throw null_reference_error();
-		if (arguments->vector[0].v_object->type != object_type::string)
-			throw invalid_arg_error();
-		s_string* str = (s_string*)arguments->vector[0].v_object;
+// Ǻδ eval_expr() ٷ ʿ
+struct eval_context;
+variable eval_expr(const expression& expr);
 
-		char* endptr;
-		double num = std::strtod(str->ptr, &endptr);
-		if (*endptr != '\0')
-			throw invalid_arg_error();
+bool to_conditional(variable var);
+std::int64_t to_integer(double n);
 
-		return variable::number(num);
-	};
-	global_object->vars[create_string("parseFloat")] = create_native_function({ str_str }, fn_parseFloat)->var();
+boost::optional<object_map::iterator> find_member(s_object* obj, s_string* name);
+boost::optional<object_map::iterator> find_local(s_string* name);
+boost::optional<object_map::iterator> find_frame_local(s_string* name);
+// atom Ű  Դϴ.  undefinedԴϴ.
+variable load_local(const expression& atom);
+
+// getf  obj   нϴ. record field column а,  undefinedԴϴ.
+variable get_member(s_object* obj, s_string* name);
+// record array name field columnԴϴ. field ƴϸ nullptrԴϴ.
+s_array* record_column(s_record_array* records, s_string* name);
+
+// setf  obj   ֽϴ. proto ã   ٲٰ,  obj  ϴ.
+// method lookup  ٲ  ִ  shape_epoch øϴ.
+// record field ƴ     ϴ.
+void set_member(s_object* obj, s_string* name, variable val);
+
+variable call_function(s_function* fn, variable new_this, s_array* arguments);
+
+// setl     ֽϴ. ã ϸ  ٱ frame(Ǵ global)  ϴ.
+void assign_local(s_string* name, variable val);
+
+// obj name  Լ  Լ, ƴϸ nullptr ȯմϴ. record field column нϴ.
+s_function* find_method(variable obj, s_string* name);
+// obj record̰ name  field . field  shape_epoch  ٲϴ.
+bool is_record_field(variable obj, s_string* name);
+
+// fn ȣ arguments 迭Դϴ. arguments ȣ   ʴ´ٸ local ϴ.
+s_array* prepare_arguments(s_function* fn, s_array& local);
+
+// new:  object  ctor ȣմϴ.
+variable construct_object(s_function* ctor, s_array* arguments);
+
+// ̸ ִ func: prototype  name setlմϴ.
+void define_constructor(s_function* fn, s_string* name);
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * escape analysis
+ * Լ ȣ⸶  arguments 迭 κ ȣ   ʽϴ.
+ * Լ  arguments Ű带  ʴ´ٸ arguments 迭 frame ۿ   Ƿ
+ * GC   ȣ  stack Ҵϰ ȣ  ȸմϴ.
+ * arguments Ű stackframe.front() 迭 ֹǷ, ٸ Լ  迭  쿡
+ * eval_expr_keyword_arguments() 迭 GC  űϴ(promote_array).
+ **/
+
+bool analyze_arguments_escape(const expression& body);
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * baseline JIT (x86-64)
+ *  ȣǴ Լ  keyword  template  űϴ.
+ *  , , if/while/do/and/or/not,       ǰ
+ *  (Լ ȣ, getf/setf, new ) runtime helper  eval_expr() մϴ.
+ * ڳ conditional ;  ڸ ٸ type  type guard մϴ.
+ * ̶ interpreter  ܸ , а ݺǸ  Լ interpreter ưϴ.
+ *  C++ ܸ   Ƿ helper ܸ  ξٰ jit_run() ٽ ϴ.
+ **/
+
+std::uint32_t jit_threshold = 1000;
+const std::uint32_t jit_deopt_limit = 4;
+
+bool jit_compile(const function_template& templ);
+variable jit_run(const function_template& templ);
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ *   
+ * Լ tree-walking interpreter(tier 0) մϴ.
+ * ȣ Ƚ while  back-edge Ƚ  hotness warm_threshold ̸
+ *  static type ߷ type ˻縦  ϴ AST(tier 1), jit_threshold ̸ (tier 2) øϴ.
+ * back-edge backedge_weight ȣ   Ĩϴ.     ٲ  Ƿ
+ * back-edge tier 1 ø tier 2  ȣ⿡ øϴ.
+ * īʹ function_template Ƿ  func expression  closure Բ ϴ.
+ *  REPL  Է¸ replConfig tierLog, warmThreshold, jitThreshold оɴϴ.
+ **/
+
+std::uint32_t warm_threshold = 2;
+const std::uint32_t backedge_weight = 16;
+bool tier_log = false;
+
+// fn tier tier øϴ.  Ͽ ϸ tier 1 ӹϴ.
+void promote_function(s_function* fn, std::uint8_t tier);
+//   tier 1 ƿ  մϴ.
+void demote_function(s_function* fn);
+
+inline std::uint32_t function_hotness(const function_template& templ)
+{
+	return templ.call_count + templ.backedge_count / backedge_weight;
 }
 
-bool read_expr(std::istream& strm, expression& ret, const std::weak_ptr<expression>& root)
+inline void count_backedge(s_function* fn)
 {
-	auto getc = [&strm]
-	{
-		if (strm.eof())
-			return -1;
-		int ch = io::get(strm);
-		return ch;
-	};
+	const function_template* templ = fn->templ;
+	if (templ->tier >= 2 || templ->jit_failed || templ->backedge_count == UINT32_MAX)
+		return;
 
-	int ch;
+	++templ->backedge_count;
+	if (templ->tier == 0 && function_hotness(*templ) >= warm_threshold)
+		promote_function(fn, 1);
+}
 
-	do
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * AOT transpiler
+ * liscript --aot [script] [output] /module/ ϸ script C++ ҽ Ű output ϴ.
+ *  ҽ runtime Բ ϸ  module ̸(ϸ script  ̸) ϵǰ,
+ * loadModule script expr ʷ  Ͱ   ϴ.
+ *  runtime ȣϴ interface aot.h ֽϴ.
+ **/
+
+void aot_transpile(std::istream& in, std::ostream& out, const std::string& module_name);
+variable aot_load_module(const std::string& name);
+
+/**
+ *  Լ
+ **/
+
+void print_var(std::ostream& strm, variable var, int indent = 0);
+void dump_expr(const expression& expr, int indent = 0);
+std::string expr_to_string(const expression& expr, std::size_t limit = 60);
+// body     node  type feedback մϴ.
+void dump_type_feedback(std::ostream& strm, const expression& body);
+// body ȿ type ˻簡  site մϴ.
+void dump_static_types(std::ostream& strm, const expression& body);
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ *  ˻ Լ
+ * global_object stackframe   object ȸ object_type proto ̸ մϴ.
+ * shallow size object ڽ ϴ ũ, retained size  object   Բ Ǵ ũԴϴ.
+ **/
+
+void heap_snapshot(std::ostream& report, std::ostream* json);
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Ҵ ġ profiler
+ * alloc_profile_enabled ̸ create Լ Ҵ Ƚ ũ⸦
+ *   expression(alloc_site)  expression  liscript Լ մϴ.
+ * alloc_profile_enabled REPL  Է¸ replConfig.profileAlloc оɴϴ.
+ **/
+
+bool alloc_profile_enabled = false;
+const expression* alloc_site = nullptr;
+
+void record_alloc(object_type type, std::size_t bytes);
+void dump_alloc_profile(std::ostream& strm);
+
+// eval_expr() ϴ  alloc_site ϰ   ǵϴ.
+class alloc_site_guard
+{
+public:
+	explicit alloc_site_guard(const expression& expr)
 	{
-		ch = getc();
-		if (ch == '\n' || ch == -1)
-			return false;
+		if (alloc_profile_enabled)
+		{
+			active_ = true;
+			saved_ = alloc_site;
+			alloc_site = &expr;
+		}
 	}
-	while (std::isspace(ch));
+	~alloc_site_guard()
+	{
+		if (active_)
+			alloc_site = saved_;
+	}
+	alloc_site_guard(const alloc_site_guard&) = delete;
+	alloc_site_guard& operator =(const alloc_site_guard&) = delete;
 
-	std::string value;
+private:
+	bool active_ { false };
+	const expression* saved_ { nullptr };
+};
 
-	if (ch == '"')
+////////////////////////////////////////////////////////////////////////////////
+
+// Read-Eval-Print-Loop  boost.iostream sourceԴϴ.
+class repl_source
+{
+public:
+	typedef char char_type;
+	typedef io::source_tag category;
+
+	std::streamsize read(char* s, std::streamsize n)
 	{
-		ret.type = expr_type::string;
+		int ch = getc();
+		if (ch == -1)
+			return -1;
 
-		while (true)
-		{
-			ch = getc();
-			if (ch == -1)
-				return false;
+		*s = (char)ch;
+		return 1;
+	}
 
-			if (ch == '"')
-			{
-				break;
-			}
-			else if (ch == '\n')
-			{
-				throw unexpected_newline_error();
-			}
-			else if (ch == '\\')
-			{
-				ch = getc();
-				if (ch == -1)
-					throw unexpected_eof_error();
+	void reset_prompt()
+	{
+		first_newline_ = true;
+	}
 
-				static char tbl[256] = { 0 };
-				tbl['t'] = '\t';
-				tbl['n'] = '\n';
-				tbl['\\'] = '\\';
+	void clear()
+	{
+		line_.clear();
+		idx_ = 1;
+	}
 
-				if (tbl[ch] != 0)
-					value.push_back(tbl[ch]);
-				else
-					throw invalid_escape_error();
-			}
-			else if (std::isspace(ch))
+private:
+	int getc()
+	{
+		if (idx_ > line_.size())
+		{
+			if (first_newline_)
 			{
-				value.push_back(' ');
+				std::cout << ">> ";
+				first_newline_ = false;
 			}
 			else
 			{
-				value.push_back(ch);
+				std::cout << "-- ";
 			}
+
+			getline(std::cin, line_);
+			idx_ = 0;
+
+			if (std::cin.eof())
+				return -1;
 		}
-	}
-	else if (ch == '(')
-	{
-		ret.type = expr_type::list;
 
-		while (true)
+		if (idx_ == line_.size())
 		{
-			ch = getc();
-			if (ch == -1)
-				throw unexpected_eof_error();
+			++idx_;
+			return '\n';
+		}
+		else
+		{
+			return line_[idx_++];
+		}
+	}
 
-			if (std::isspace(ch))
-			{
-				continue;
-			}
-			else if (ch == ')')
-			{
-				break;
-			}
-			else
-			{
-				strm.unget();
+	std::string line_;
+	std::string::size_type idx_ { 1 };
+	bool first_newline_ { true };
+};
 
-				ret.list.emplace_back();
-				read_expr(strm, ret.list.back(), root);
-			}
-		}
+////////////////////////////////////////////////////////////////////////////////
+
+int aot_main(int argc, char* argv[])
+{
+	if (argc < 4)
+	{
+		std::cerr << "usage: liscript --aot [script] [output] /module/" << std::endl;
+		return 1;
+	}
+
+	std::string module_name;
+	if (argc >= 5)
+	{
+		module_name = argv[4];
 	}
 	else
 	{
-		while (true)
+		module_name = argv[2];
+		auto slash = module_name.find_last_of("/\\");
+		if (slash != std::string::npos)
+			module_name.erase(0, slash + 1);
+		auto dot = module_name.find('.');
+		if (dot != std::string::npos)
+			module_name.erase(dot);
+	}
+
+	init_scripting();
+
+	try
+	{
+		std::ifstream in(argv[2]);
+		if (!in)
+			throw file_open_error();
+
+		std::ostringstream out;
+		aot_transpile(in, out, module_name);
+
+		std::ofstream file(argv[3]);
+		if (!file)
+			throw file_open_error();
+		file << out.str();
+	}
+	catch (std::runtime_error& ex)
+	{
+		conlib::setcolor_block scb(conlib::color::red);
+		std::cerr << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc >= 2 && std::strcmp(argv[1], "--aot") == 0)
+		return aot_main(argc, argv);
+
+	io::stream<repl_source> strm;
+	strm.open(repl_source { });
+
+	init_scripting();
+
+	while (true)
+	{
+		auto expr = std::make_shared<expression>();
+		std::weak_ptr<expression> w_expr = expr;
+
+		strm->reset_prompt();
+		try
 		{
-			if (ch == '(' || ch == ')')
+			if (read_expr(strm, *expr, w_expr))
 			{
-				strm.unget();
-				break;
+				int ch = io::get(strm);
+				if (ch != -1 && ch != '\n')
+				{
+					strm->clear();
+					throw unexpected_character_error();
+				}
+
+				optimize_expr(*expr);
+
+				try
+				{
+					auto it = replconfig_object->vars.find(str_dumpexpr);
+					if (it != replconfig_object->vars.end() && to_conditional(it->second))
+					{
+						conlib::setcolor_block scb(conlib::color::darkgreen);
+						dump_expr(*expr);
+					}
+				}
+				catch (invalid_conditional&) { }
+
+				try
+				{
+					auto it = replconfig_object->vars.find(str_profilealloc);
+					alloc_profile_enabled = (it != replconfig_object->vars.end() && to_conditional(it->second));
+				}
+				catch (invalid_conditional&)
+				{
+					alloc_profile_enabled = false;
+				}
+
+				try
+				{
+					auto it = replconfig_object->vars.find(str_tierlog);
+					tier_log = (it != replconfig_object->vars.end() && to_conditional(it->second));
+				}
+				catch (invalid_conditional&)
+				{
+					tier_log = false;
+				}
+
+				// 1 ̻  ƴϸ   ״ ϴ.
+				auto read_threshold = [](s_string* name, std::uint32_t& threshold) {
+					auto it = replconfig_object->vars.find(name);
+					if (it != replconfig_object->vars.end() && it->second.type == var_type::number)
+					{
+						double v = it->second.v_number;
+						if (v >= 1 && v <= UINT32_MAX && v == std::floor(v))
+							threshold = static_cast<std::uint32_t>(v);
+					}
+				};
+				read_threshold(str_warmthreshold, warm_threshold);
+				read_threshold(str_jitthreshold, jit_threshold);
+
+				variable var = eval_expr(*expr);
+
+				print_var(std::cout, var);
+				std::cout << std::endl;
 			}
-			else if (std::isspace(ch))
+			else if (strm.eof())
 			{
-				strm.unget();
 				break;
 			}
-			else if (std::isgraph(ch))
-			{
-				value.push_back(ch);
-			}
-			else
-			{
-				if (!value.empty() && std::isdigit(value[0]))
-					throw invalid_number_error();
-				else
-					throw invalid_atom_error();
-			}
-
-			ch = getc();
-			if (ch == -1)
-				throw unexpected_eof_error();
-		}
-
-		if (!std::isdigit(value[0]))
-		{
-			ret.type = expr_type::atom;
 		}
-		else
+		catch (std::runtime_error& ex)
 		{
-			char* endptr;
-			double num = std::strtod(value.c_str(), &endptr);
-			if (*endptr != '\0')
-				throw invalid_number_error();
-
-			ret.type = expr_type::number;
-			ret.number = num;
+			conlib::setcolor_block scb(conlib::color::red);
+			std::cerr << ex.what() << std::endl;
 		}
 	}
 
-	if (ret.type != expr_type::number)
-	{
-		ret.value = create_string(value);
-	}
-	ret.root = root;
-
-	return true;
+	dump_alloc_profile(std::cout);
 }
 
-struct eval_context
+////////////////////////////////////////////////////////////////////////////////
+
+s_object* allocate_object()
 {
-};
+	s_object* obj = (s_object*)GC_MALLOC(sizeof(s_object));
+	new (obj) s_object();
 
-// atom keywords
-variable eval_expr_keyword_global(eval_context& context);
-variable eval_expr_keyword_this(eval_context& context);
-variable eval_expr_keyword_undefined(eval_context& context);
-variable eval_expr_keyword_null(eval_context& context);
-variable eval_expr_keyword_true(eval_context& context);
-variable eval_expr_keyword_false(eval_context& context);
-variable eval_expr_keyword_prev(eval_context& context);
-variable eval_expr_keyword_arguments(eval_context& context);
-variable eval_expr_keyword_dotdotdot_(eval_context& context);
+	obj->type = object_type::object;
 
-// list keywords
-variable eval_expr_keyword_func(const expression& expr, eval_context& context);
-variable eval_expr_keyword_new(const expression& expr, eval_context& context);
-variable eval_expr_keyword_array(const expression& expr, eval_context& context);
-variable eval_expr_keyword_getf(const expression& expr, eval_context& context);
-variable eval_expr_keyword_setf(const expression& expr, eval_context& context);
-variable eval_expr_keyword_getl(const expression& expr, eval_context& context);
-variable eval_expr_keyword_setl(const expression& expr, eval_context& context);
-variable eval_expr_keyword_geti(const expression& expr, eval_context& context);
-variable eval_expr_keyword_seti(const expression& expr, eval_context& context);
-variable eval_expr_keyword_do(const expression& expr, eval_context& context);
-variable eval_expr_keyword_if(const expression& expr, eval_context& context);
-variable eval_expr_keyword_while(const expression& expr, eval_context& context);
-variable eval_expr_keyword_plus_(const expression& expr, eval_context& context);
-variable eval_expr_keyword_minus_(const expression& expr, eval_context& context);
-variable eval_expr_keyword_multiply_(const expression& expr, eval_context& context);
-variable eval_expr_keyword_division_(const expression& expr, eval_context& context);
-variable eval_expr_keyword_modulo_(const expression& expr, eval_context& context);
-variable eval_expr_keyword_idiv(const expression& expr, eval_context& context);
-variable eval_expr_keyword_imod(const expression& expr, eval_context& context);
-variable eval_expr_keyword_bitand_(const expression& expr, eval_context& context);
-variable eval_expr_keyword_bitor_(const expression& expr, eval_context& context);
-variable eval_expr_keyword_bitxor_(const expression& expr, eval_context& context);
-variable eval_expr_keyword_and(const expression& expr, eval_context& context);
-variable eval_expr_keyword_or(const expression& expr, eval_context& context);
-variable eval_expr_keyword_not(const expression& expr, eval_context& context);
-variable eval_expr_keyword_eq_(const expression& expr, eval_context& context);
-variable eval_expr_keyword_ne_(const expression& expr, eval_context& context);
-variable eval_expr_keyword_lt_(const expression& expr, eval_context& context);
-variable eval_expr_keyword_lte_(const expression& expr, eval_context& context);
-variable eval_expr_keyword_gt_(const expression& expr, eval_context& context);
-variable eval_expr_keyword_gte_(const expression& expr, eval_context& context);
+	GC_REGISTER_FINALIZER(obj, [](void* r_obj, void* cdata)
+	{
+		delete (s_object*)r_obj;
+	}, nullptr, nullptr, nullptr);
 
-using atom_keyword_map_t = std::unordered_map<
-	std::string, std::function<variable(eval_context& context)>>;
-using list_keyword_map_t = std::unordered_map<
-	std::string, std::function<variable(const expression& expr, eval_context& context)>>;
-atom_keyword_map_t atom_keyword_map = {
-	{ "global",		eval_expr_keyword_global },
-	{ "this",		eval_expr_keyword_this },
-	{ "undefined",	eval_expr_keyword_undefined },
-	{ "null",		eval_expr_keyword_null },
-	{ "true",		eval_expr_keyword_true },
-	{ "false",		eval_expr_keyword_false },
-	{ "prev",		eval_expr_keyword_prev },
-	{ "arguments",	eval_expr_keyword_arguments },
-	{ "...",		eval_expr_keyword_dotdotdot_ },
-};
-list_keyword_map_t list_keyword_map = {
-	{ "func",		eval_expr_keyword_func },
-	{ "new",		eval_expr_keyword_new },
-	{ "array",		eval_expr_keyword_array },
-	{ "getf",		eval_expr_keyword_getf },
-	{ "setf",		eval_expr_keyword_setf },
-	{ "getl",		eval_expr_keyword_getl },
-	{ "setl",		eval_expr_keyword_setl },
-	{ "geti",		eval_expr_keyword_geti },
-	{ "seti",		eval_expr_keyword_seti },
-	{ "do",			eval_expr_keyword_do },
-	{ "if",			eval_expr_keyword_if },
-	{ "while",		eval_expr_keyword_while },
-	{ "+",			eval_expr_keyword_plus_ },
-	{ "-",			eval_expr_keyword_minus_ },
-	{ "*",			eval_expr_keyword_multiply_ },
-	{ "/",			eval_expr_keyword_division_ },
-	{ "%",			eval_expr_keyword_modulo_ },
-	{ "idiv",		eval_expr_keyword_idiv },
-	{ "imod",		eval_expr_keyword_imod },
-	{ "&",			eval_expr_keyword_bitand_ },
-	{ "|",			eval_expr_keyword_bitor_ },
-	{ "^",			eval_expr_keyword_bitxor_ },
-	{ "and",		eval_expr_keyword_and },
-	{ "or",			eval_expr_keyword_or },
-	{ "not",		eval_expr_keyword_not },
-	{ "=",			eval_expr_keyword_eq_ },
-	{ "/=",			eval_expr_keyword_ne_ },
-	{ "<",			eval_expr_keyword_lt_ },
-	{ "<=",			eval_expr_keyword_lte_ },
-	{ ">",			eval_expr_keyword_gt_ },
-	{ ">=",			eval_expr_keyword_gte_ },
-};
+	return obj;
+}
 
-bool is_keyword(const std::string &str)
+s_object* create_object()
 {
-	return (atom_keyword_map.find(str) != atom_keyword_map.end()
-		|| list_keyword_map.find(str) != list_keyword_map.end());
+	s_object* obj = allocate_object();
+	obj->proto = p_Object;
+	obj->name = str_empty;
+
+	if (alloc_profile_enabled)
+		record_alloc(object_type::object, sizeof(s_object));
+	return obj;
 }
 
-variable eval_expr(const expression& expr)
+s_string* allocate_string(const std::string& str)
 {
-	eval_context context;
+	return allocate_string(str.c_str(), str.size());
+}
 
-	if (expr.type == expr_type::string)
-	{
-		return variable::object(expr.value->obj());
-	}
-	else if (expr.type == expr_type::number)
-	{
+s_string* allocate_string(const char* ptr, std::size_t size)
+{
+	s_string* obj = (s_string*)GC_MALLOC(sizeof(s_string) + size + 1);
+	new (obj) s_string();
+
+	obj->_obj.type = object_type::string;
+	obj->ptr = (char*)obj + sizeof(s_string);
+	obj->size = size;
+	obj->hash = 0;
+	obj->base = nullptr;
+	std::memcpy((char*)obj->ptr, ptr, size);
+	((char*)obj->ptr)[size] = '\0';
+
+	GC_REGISTER_FINALIZER(obj, [](void* r_obj, void* cdata) {
+		delete (s_string*)r_obj;
+	}, nullptr, nullptr, nullptr);
+
+	return obj;
+}
+
+s_string* create_string(const std::string& str)
+{
+	return create_string(str.c_str(), str.size());
+}
+
+s_string* create_string(const char* ptr, std::size_t size)
+{
+	if (size == 0)
+		return str_empty;
+
+	s_string* obj = allocate_string(ptr, size);
+	obj->_obj.proto = p_String;
+	obj->_obj.name = str_empty;
+
+	if (alloc_profile_enabled)
+		record_alloc(object_type::string, sizeof(s_string) + size + 1);
+	return obj;
+}
+
+s_string* create_slice(s_string* parent, std::size_t offset, std::size_t size)
+{
+	assert(offset + size <= parent->size);
+	if (size == 0)
+		return str_empty;
+	if (size == parent->size)
+		return parent;
+
+	s_string* obj = (s_string*)GC_MALLOC(sizeof(s_string));
+	new (obj) s_string();
+
+	obj->_obj.type = object_type::string;
+	obj->_obj.proto = p_String;
+	obj->_obj.name = str_empty;
+	obj->ptr = parent->ptr + offset;
+	obj->size = size;
+	obj->hash = 0;
+	// slice slice ó buffer ٷ Ű ؼ ߰ slice ŵ  ְ մϴ.
+	obj->base = (parent->base != nullptr) ? parent->base : parent;
+
+	GC_REGISTER_FINALIZER(obj, [](void* r_obj, void* cdata) {
+		delete (s_string*)r_obj;
+	}, nullptr, nullptr, nullptr);
+
+	if (alloc_profile_enabled)
+		record_alloc(object_type::string, sizeof(s_string));
+	return obj;
+}
+
+s_string* own_string(s_string* str)
+{
+	return (str->base != nullptr) ? create_string(str->ptr, str->size) : str;
+}
+
+std::shared_ptr<function_template> make_function_template(const gc_vector<s_string*>& parameters, const expression& expr, bool is_variadic /* = false */)
+{
+	auto templ = std::make_shared<function_template>();
+	templ->parameters = parameters;
+	templ->is_variadic = is_variadic;
+	templ->arguments_escape = analyze_arguments_escape(expr);
+	templ->is_native = false;
+	templ->expr = &expr;
+	templ->intrinsic = intrinsic_kind::none;
+	templ->result_epoch = nullptr;
+	for (s_string* name : parameters)
+		register_frame_name(name);
+	return templ;
+}
+
+std::shared_ptr<function_template> make_native_template(const gc_vector<s_string*>& parameters, native_fn_t native_fn, bool is_variadic /* = false */)
+{
+	auto templ = std::make_shared<function_template>();
+	templ->parameters = parameters;
+	templ->is_variadic = is_variadic;
+	templ->arguments_escape = false;
+	templ->is_native = true;
+	templ->native_fn = native_fn;
+	templ->intrinsic = intrinsic_kind::none;
+	templ->result_epoch = nullptr;
+	for (s_string* name : parameters)
+		register_frame_name(name);
+	return templ;
+}
+
+s_function* allocate_function(const function_template* templ, std::shared_ptr<expression> expr_root)
+{
+	s_function* obj = (s_function*)GC_MALLOC(sizeof(s_function));
+	new (obj) s_function();
+
+	obj->_obj.type = object_type::function;
+	obj->templ = templ;
+	obj->expr_root = std::move(expr_root);
+
+	GC_REGISTER_FINALIZER(obj, [](void* r_obj, void* cdata) {
+		delete (s_function*)r_obj;
+	}, nullptr, nullptr, nullptr);
+
+	return obj;
+}
+
+s_function* create_function(const function_template* templ, std::shared_ptr<expression> expr_root)
+{
+	s_function* obj = allocate_function(templ, std::move(expr_root));
+	obj->_obj.proto = p_Function;
+	obj->_obj.name = str_empty;
+
+	if (alloc_profile_enabled)
+		record_alloc(object_type::function, sizeof(s_function));
+	return obj;
+}
+
+s_function* create_native_function(const gc_vector<s_string*>& parameters, native_fn_t native_fn, bool is_variadic /* = false */,
+	const std::uint64_t* result_epoch /* = nullptr */, intrinsic_kind intrinsic /* = intrinsic_kind::none */)
+{
+	static std::vector<std::shared_ptr<function_template>> native_templates;
+
+	native_templates.push_back(make_native_template(parameters, native_fn, is_variadic));
+	native_templates.back()->result_epoch = result_epoch;
+	native_templates.back()->intrinsic = intrinsic;
+	return create_function(native_templates.back().get(), nullptr);
+}
+
+s_array* allocate_array()
+{
+	s_array* obj = (s_array*)GC_MALLOC(sizeof(s_array));
+	new (obj) s_array();
+
+	obj->_obj.type = object_type::array;
+	obj->kind = elements_kind::generic;
+
+	GC_REGISTER_FINALIZER(obj, [](void* r_obj, void* cdata) {
+		delete (s_array*)r_obj;
+	}, nullptr, nullptr, nullptr);
+
+	return obj;
+}
+
+s_array* create_array(elements_kind kind /* = elements_kind::generic */)
+{
+	s_array* obj = allocate_array();
+	obj->_obj.proto = p_Array;
+	obj->_obj.name = str_empty;
+	obj->kind = kind;
+
+	if (alloc_profile_enabled)
+		record_alloc(object_type::array, sizeof(s_array));
+	return obj;
+}
+
+// s_array ׸
+
+namespace
+{
+	// -0 int32  0 ǹǷ packed_int  ʽϴ.
+	bool is_small_int(double d)
+	{
+		return d >= INT32_MIN && d <= INT32_MAX && static_cast<std::int32_t>(d) == d && !(d == 0 && std::signbit(d));
+	}
+
+	// v   ִ   kindԴϴ.
+	elements_kind kind_of(variable v)
+	{
+		if (v.type != var_type::number)
+			return elements_kind::generic;
+		return is_small_int(v.v_number) ? elements_kind::packed_int : elements_kind::packed_double;
+	}
+}
+
+inline std::size_t s_array::size() const
+{
+	switch (kind)
+	{
+	case elements_kind::packed_int:
+		return ints.size();
+	case elements_kind::packed_double:
+		return doubles.size();
+	default:
+		return vector.size();
+	}
+}
+
+inline variable s_array::get(std::size_t i) const
+{
+	switch (kind)
+	{
+	case elements_kind::packed_int:
+		return variable::number(ints[i]);
+	case elements_kind::packed_double:
+		return variable::number(doubles[i]);
+	default:
+		return vector[i];
+	}
+}
+
+inline void s_array::set(std::size_t i, variable v)
+{
+	if (kind_of(v) > kind)
+		widen(kind_of(v));
+
+	switch (kind)
+	{
+	case elements_kind::packed_int:
+		ints[i] = static_cast<std::int32_t>(v.v_number);
+		break;
+	case elements_kind::packed_double:
+		doubles[i] = v.v_number;
+		break;
+	default:
+		vector[i] = v;
+		break;
+	}
+}
+
+void s_array::push_back(variable v)
+{
+	if (kind_of(v) > kind)
+		widen(kind_of(v));
+	++array_length_epoch;
+
+	switch (kind)
+	{
+	case elements_kind::packed_int:
+		ints.push_back(static_cast<std::int32_t>(v.v_number));
+		break;
+	case elements_kind::packed_double:
+		doubles.push_back(v.v_number);
+		break;
+	default:
+		vector.push_back(v);
+		break;
+	}
+}
+
+void s_array::pop_back()
+{
+	++array_length_epoch;
+	switch (kind)
+	{
+	case elements_kind::packed_int:
+		ints.pop_back();
+		break;
+	case elements_kind::packed_double:
+		doubles.pop_back();
+		break;
+	default:
+		vector.pop_back();
+		break;
+	}
+}
+
+void s_array::reserve(std::size_t capacity)
+{
+	try
+	{
+		switch (kind)
+		{
+		case elements_kind::packed_int:
+			ints.reserve(capacity);
+			break;
+		case elements_kind::packed_double:
+			doubles.reserve(capacity);
+			break;
+		default:
+			vector.reserve(capacity);
+			break;
+		}
+	}
+	catch (std::bad_alloc&)
+	{
+		throw out_of_range_error();
+	}
+	catch (std::length_error&)
+	{
+		throw out_of_range_error();
+	}
+}
+
+void s_array::assign(const variable* items, std::size_t count)
+{
+	elements_kind to = kind;
+	for (std::size_t i = 0; i < count; ++i)
+		to = std::max(to, kind_of(items[i]));
+
+	ints.clear();
+	doubles.clear();
+	vector.clear();
+	kind = to;
+	++array_length_epoch;
+
+	reserve(count);
+	for (std::size_t i = 0; i < count; ++i)
+		push_back(items[i]);
+}
+
+void s_array::append(const s_array* src, std::size_t begin, std::size_t end)
+{
+	if (src->kind > kind)
+		widen(src->kind);
+	++array_length_epoch;
+
+	if (src->kind == kind)
+	{
+		switch (kind)
+		{
+		case elements_kind::packed_int:
+			ints.insert(ints.end(), src->ints.begin() + begin, src->ints.begin() + end);
+			break;
+		case elements_kind::packed_double:
+			doubles.insert(doubles.end(), src->doubles.begin() + begin, src->doubles.begin() + end);
+			break;
+		default:
+			vector.insert(vector.end(), src->vector.begin() + begin, src->vector.begin() + end);
+			break;
+		}
+		return;
+	}
+
+	reserve(size() + (end - begin));
+	for (std::size_t i = begin; i < end; ++i)
+		push_back(src->get(i));
+}
+
+void s_array::widen(elements_kind to)
+{
+	assert(to > kind);
+
+	if (to == elements_kind::packed_double)
+	{
+		doubles.assign(ints.begin(), ints.end());
+	}
+	else
+	{
+		vector.reserve(size());
+		for (std::size_t i = 0, n = size(); i < n; ++i)
+			vector.push_back(get(i));
+	}
+
+	//  vector ٲ㼭 packed  ݴϴ.
+	if (kind == elements_kind::packed_int)
+		gc_atomic_vector<std::int32_t>().swap(ints);
+	else
+		gc_atomic_vector<double>().swap(doubles);
+	kind = to;
+}
+
+namespace
+{
+	const std::size_t simd_alignment = 32;
+
+	std::size_t element_size(element_type element)
+	{
+		return element == element_type::float64 ? sizeof(double) : sizeof(std::int32_t);
+	}
+}
+
+s_typed_array* allocate_typed_array(element_type element, std::size_t size)
+{
+	if (size > max_array_length || size > (SIZE_MAX - simd_alignment) / element_size(element))
+		throw out_of_range_error();
+	std::size_t bytes = size * element_size(element);
+
+	s_typed_array* obj = (s_typed_array*)GC_MALLOC(sizeof(s_typed_array));
+	new (obj) s_typed_array();
+
+	obj->_obj.type = object_type::typed_array;
+	obj->element = element;
+	obj->size = size;
+
+	obj->base = GC_MALLOC_ATOMIC(bytes + simd_alignment);
+	if (obj->base == nullptr)
+		throw out_of_range_error();
+	std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(obj->base);
+	obj->data = reinterpret_cast<void*>((addr + simd_alignment - 1) & ~static_cast<std::uintptr_t>(simd_alignment - 1));
+	std::memset(obj->data, 0, bytes);
+
+	GC_REGISTER_FINALIZER(obj, [](void* r_obj, void* cdata) {
+		delete (s_typed_array*)r_obj;
+	}, nullptr, nullptr, nullptr);
+
+	return obj;
+}
+
+s_typed_array* create_typed_array(element_type element, std::size_t size)
+{
+	s_typed_array* obj = allocate_typed_array(element, size);
+	obj->_obj.proto = (element == element_type::float64) ? p_Float64Array : p_Int32Array;
+	obj->_obj.name = str_empty;
+
+	// Ҵ ġ profiler typed array array ϴ.
+	if (alloc_profile_enabled)
+		record_alloc(object_type::array, sizeof(s_typed_array) + size * element_size(element));
+	return obj;
+}
+
+s_record_array* create_record_array(s_object* record_proto, const gc_vector<s_string*>& fields)
+{
+	s_record_array* obj = (s_record_array*)GC_MALLOC(sizeof(s_record_array));
+	new (obj) s_record_array();
+
+	obj->_obj.type = object_type::record_array;
+	obj->_obj.proto = p_RecordArray;
+	obj->_obj.name = str_empty;
+	obj->record_proto = record_proto;
+	obj->fields = fields;
+	obj->size = 0;
+	for (std::size_t i = 0; i < fields.size(); ++i)
+		obj->columns.push_back(create_array(elements_kind::packed_int));
+
+	GC_REGISTER_FINALIZER(obj, [](void* r_obj, void* cdata) {
+		delete (s_record_array*)r_obj;
+	}, nullptr, nullptr, nullptr);
+
+	if (alloc_profile_enabled)
+		record_alloc(object_type::array, sizeof(s_record_array));
+	return obj;
+}
+
+s_record* create_record(s_record_array* owner, std::size_t index)
+{
+	s_record* obj = (s_record*)GC_MALLOC(sizeof(s_record));
+	new (obj) s_record();
+
+	obj->_obj.type = object_type::record;
+	obj->_obj.proto = owner->record_proto;
+	obj->_obj.name = str_empty;
+	obj->owner = owner;
+	obj->index = index;
+
+	GC_REGISTER_FINALIZER(obj, [](void* r_obj, void* cdata) {
+		delete (s_record*)r_obj;
+	}, nullptr, nullptr, nullptr);
+
+	if (alloc_profile_enabled)
+		record_alloc(object_type::object, sizeof(s_record));
+	return obj;
+}
+
+s_map* create_map()
+{
+	s_map* obj = (s_map*)GC_MALLOC(sizeof(s_map));
+	new (obj) s_map();
+
+	obj->_obj.type = object_type::map;
+	obj->_obj.proto = p_Map;
+	obj->_obj.name = str_empty;
+	obj->size = 0;
+	obj->deleted = 0;
+
+	GC_REGISTER_FINALIZER(obj, [](void* r_obj, void* cdata) {
+		delete (s_map*)r_obj;
+	}, nullptr, nullptr, nullptr);
+
+	if (alloc_profile_enabled)
+		record_alloc(object_type::object, sizeof(s_map));
+	return obj;
+}
+
+s_string_builder* create_string_builder()
+{
+	s_string_builder* obj = (s_string_builder*)GC_MALLOC(sizeof(s_string_builder));
+	new (obj) s_string_builder();
+
+	obj->_obj.type = object_type::string_builder;
+	obj->_obj.proto = p_StringBuilder;
+	obj->_obj.name = str_empty;
+	obj->flat = nullptr;
+
+	GC_REGISTER_FINALIZER(obj, [](void* r_obj, void* cdata) {
+		delete (s_string_builder*)r_obj;
+	}, nullptr, nullptr, nullptr);
+
+	if (alloc_profile_enabled)
+		record_alloc(object_type::object, sizeof(s_string_builder));
+	return obj;
+}
+
+void init_frame_local_array(s_array& arr)
+{
+	arr._obj.type = object_type::array;
+	arr._obj.proto = p_Array;
+	arr._obj.name = str_empty;
+	arr.kind = elements_kind::generic;
+	arr.frame_local = true;
+}
+
+s_array* promote_array(s_array* arr)
+{
+	s_array* ret = create_array();
+	ret->vector = arr->vector;
+	ret->_obj.vars = arr->_obj.vars;
+	return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Array native 
+ * sort introsortԴϴ.   insertion sort, Ͱ ʹ  heap sort ٲߴϴ.
+ *  Լ ϰ   ִ 迭   ʰ,  ׸  ⸸ մϴ.
+ **/
+
+namespace
+{
+	s_array* this_array(variable this_var)
+	{
+		if (this_var.type != var_type::object)
+			throw not_array_error();
+		if (this_var.v_object == nullptr)
+			throw null_reference_error();
+		if (this_var.v_object->type != object_type::array)
+			throw not_array_error();
+		return (s_array*)this_var.v_object;
+	}
+
+	s_record_array* this_record_array(variable this_var)
+	{
+		if (this_var.type != var_type::object)
+			throw not_array_error();
+		if (this_var.v_object == nullptr)
+			throw null_reference_error();
+		if (this_var.v_object->type != object_type::record_array)
+			throw not_array_error();
+		return (s_record_array*)this_var.v_object;
+	}
+
+	// 0 ̻ limit   native ڸ size_t ٲߴϴ.
+	std::size_t to_array_position(variable v, std::size_t limit)
+	{
+		if (v.type != var_type::number)
+			throw invalid_arg_error();
+
+		std::int64_t n;
+		try
+		{
+			n = to_integer(v.v_number);
+		}
+		catch (not_integer_error&)
+		{
+			throw invalid_arg_error();
+		}
+
+		if (n < 0 || static_cast<std::uint64_t>(n) > limit)
+			throw out_of_range_error();
+		return static_cast<std::size_t>(n);
+	}
+
+	const std::ptrdiff_t insertion_sort_limit = 16;
+
+	template <typename T, typename Less>
+	void insertion_sort(T* a, std::ptrdiff_t n, Less& less)
+	{
+		for (std::ptrdiff_t i = 1; i < n; ++i)
+		{
+			T v = a[i];
+			std::ptrdiff_t j = i;
+			for (; j > 0 && less(v, a[j - 1]); --j)
+				a[j] = a[j - 1];
+			a[j] = v;
+		}
+	}
+
+	template <typename T, typename Less>
+	void sift_down(T* a, std::ptrdiff_t i, std::ptrdiff_t n, Less& less)
+	{
+		for (;;)
+		{
+			std::ptrdiff_t child = 2 * i + 1;
+			if (child >= n)
+				return;
+			if (child + 1 < n && less(a[child], a[child + 1]))
+				++child;
+			if (!less(a[i], a[child]))
+				return;
+			std::swap(a[i], a[child]);
+			i = child;
+		}
+	}
+
+	template <typename T, typename Less>
+	void heap_sort(T* a, std::ptrdiff_t n, Less& less)
+	{
+		for (std::ptrdiff_t i = n / 2; i-- > 0; )
+			sift_down(a, i, n, less);
+		for (std::ptrdiff_t end = n - 1; end > 0; --end)
+		{
+			std::swap(a[0], a[end]);
+			sift_down(a, 0, end, less);
+		}
+	}
+
+	template <typename T, typename Less>
+	void introsort_loop(T* a, std::ptrdiff_t n, int depth, Less& less)
+	{
+		while (n > insertion_sort_limit)
+		{
+			if (depth-- == 0)
+			{
+				heap_sort(a, n, less);
+				return;
+			}
+
+			//   ߾Ӱ pivot ϴ.
+			std::ptrdiff_t mid = n / 2;
+			if (less(a[mid], a[0]))
+				std::swap(a[mid], a[0]);
+			if (less(a[n - 1], a[mid]))
+			{
+				std::swap(a[n - 1], a[mid]);
+				if (less(a[mid], a[0]))
+					std::swap(a[mid], a[0]);
+			}
+			T pivot = a[mid];
+
+			// Hoare partitionԴϴ.  Լ  ʰ index  ȿ ӹ մϴ.
+			std::ptrdiff_t i = -1, j = n;
+			for (;;)
+			{
+				do ++i; while (i < n - 1 && less(a[i], pivot));
+				do --j; while (j > 0 && less(pivot, a[j]));
+				if (i >= j)
+					break;
+				std::swap(a[i], a[j]);
+			}
+			std::ptrdiff_t split = std::min(std::max(j + 1, std::ptrdiff_t(1)), n - 1);
+
+			//   ͷ  stack ̸ log n ϴ.
+			if (split < n - split)
+			{
+				introsort_loop(a, split, depth, less);
+				a += split;
+				n -= split;
+			}
+			else
+			{
+				introsort_loop(a + split, n - split, depth, less);
+				n = split;
+			}
+		}
+		insertion_sort(a, n, less);
+	}
+
+	template <typename T, typename Less>
+	void introsort(T* a, std::size_t n, Less less)
+	{
+		int depth = 0;
+		for (std::size_t k = n; k > 1; k >>= 1)
+			depth += 2;
+		introsort_loop(a, static_cast<std::ptrdiff_t>(n), depth, less);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * typed array kernel
+ * Float64Array kernel x86-64 CPU AVX2 ϸ 256bit SIMD, ƴϸ scalar մϴ.
+ * sum, dot, min, max 8 lane κ      Ĩϴ.
+ * scalar ε  lane  Ƿ  ε  bit  ϴ.
+ * Һ     ϰ FMA  ʽϴ.
+ * Int32Array kernel scalar̸   Ȯϰ մϴ.
+ **/
+
+namespace
+{
+	const std::size_t simd_lanes = 8;
+
+	bool cpu_has_avx2()
+	{
+#if defined(LISCRIPT_SIMD) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+
+		// ü AVX (XMM, YMM)  ִ Ȯմϴ.
+		__cpuid(info, 1);
+		if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)
+			return false;
+		if ((_xgetbv(0) & 6) != 6)
+			return false;
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#elif defined(LISCRIPT_SIMD)
+		return __builtin_cpu_supports("avx2") != 0;
+#else
+		return false;
+#endif
+	}
+
+	bool has_avx2()
+	{
+		static const bool supported = cpu_has_avx2();
+		return supported;
+	}
+
+	struct sum_op
+	{
+		static double scalar(double a, double b) { return a + b; }
+#ifdef LISCRIPT_SIMD
+		LISCRIPT_AVX2 static __m256d vector(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+#endif
+	};
+
+	// _mm256_min_pd, _mm256_max_pd  NaN   °  ϴ.
+	struct min_op
+	{
+		static double scalar(double a, double b) { return a < b ? a : b; }
+#ifdef LISCRIPT_SIMD
+		LISCRIPT_AVX2 static __m256d vector(__m256d a, __m256d b) { return _mm256_min_pd(a, b); }
+#endif
+	};
+
+	struct max_op
+	{
+		static double scalar(double a, double b) { return a > b ? a : b; }
+#ifdef LISCRIPT_SIMD
+		LISCRIPT_AVX2 static __m256d vector(__m256d a, __m256d b) { return _mm256_max_pd(a, b); }
+#endif
+	};
+
+	//  ׸ lane ְ lane (0+4, 1+5, 2+6, 3+7)  Ĩϴ.
+	template <typename Op>
+	double reduce_lanes(double* acc, const double* x, std::size_t i, std::size_t n)
+	{
+		for (; i < n; ++i)
+			acc[i % simd_lanes] = Op::scalar(acc[i % simd_lanes], x[i]);
+
+		double t[4];
+		for (std::size_t k = 0; k < 4; ++k)
+			t[k] = Op::scalar(acc[k], acc[k + 4]);
+		return Op::scalar(Op::scalar(t[0], t[1]), Op::scalar(t[2], t[3]));
+	}
+
+	template <typename Op>
+	double reduce_scalar(const double* x, std::size_t n, double init)
+	{
+		double acc[simd_lanes];
+		std::fill(acc, acc + simd_lanes, init);
+
+		std::size_t i = 0;
+		for (; i + simd_lanes <= n; i += simd_lanes)
+		{
+			for (std::size_t k = 0; k < simd_lanes; ++k)
+				acc[k] = Op::scalar(acc[k], x[i + k]);
+		}
+		return reduce_lanes<Op>(acc, x, i, n);
+	}
+
+	double dot_scalar(const double* x, const double* y, std::size_t n)
+	{
+		double acc[simd_lanes] = { };
+
+		std::size_t i = 0;
+		for (; i + simd_lanes <= n; i += simd_lanes)
+		{
+			for (std::size_t k = 0; k < simd_lanes; ++k)
+				acc[k] += x[i + k] * y[i + k];
+		}
+		for (; i < n; ++i)
+			acc[i % simd_lanes] += x[i] * y[i];
+		return reduce_lanes<sum_op>(acc, x, n, n);
+	}
+
+#ifdef LISCRIPT_SIMD
+	template <typename Op>
+	LISCRIPT_AVX2 double reduce_avx2(const double* x, std::size_t n, double init)
+	{
+		__m256d a0 = _mm256_set1_pd(init);
+		__m256d a1 = a0;
+
+		std::size_t i = 0;
+		for (; i + simd_lanes <= n; i += simd_lanes)
+		{
+			a0 = Op::vector(a0, _mm256_loadu_pd(x + i));
+			a1 = Op::vector(a1, _mm256_loadu_pd(x + i + 4));
+		}
+
+		double acc[simd_lanes];
+		_mm256_storeu_pd(acc, a0);
+		_mm256_storeu_pd(acc + 4, a1);
+		return reduce_lanes<Op>(acc, x, i, n);
+	}
+
+	LISCRIPT_AVX2 double dot_avx2(const double* x, const double* y, std::size_t n)
+	{
+		__m256d a0 = _mm256_setzero_pd();
+		__m256d a1 = a0;
+
+		std::size_t i = 0;
+		for (; i + simd_lanes <= n; i += simd_lanes)
+		{
+			a0 = _mm256_add_pd(a0, _mm256_mul_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+			a1 = _mm256_add_pd(a1, _mm256_mul_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4)));
+		}
+
+		double acc[simd_lanes];
+		_mm256_storeu_pd(acc, a0);
+		_mm256_storeu_pd(acc + 4, a1);
+		for (; i < n; ++i)
+			acc[i % simd_lanes] += x[i] * y[i];
+		return reduce_lanes<sum_op>(acc, x, n, n);
+	}
+
+	// y = y op x
+	template <typename Op>
+	LISCRIPT_AVX2 void elementwise_avx2(double* y, const double* x, std::size_t n)
+	{
+		std::size_t i = 0;
+		for (; i + 4 <= n; i += 4)
+			_mm256_storeu_pd(y + i, Op::vector(_mm256_loadu_pd(y + i), _mm256_loadu_pd(x + i)));
+		for (; i < n; ++i)
+			y[i] = Op::scalar(y[i], x[i]);
+	}
+
+	LISCRIPT_AVX2 void scale_avx2(double* y, double a, std::size_t n)
+	{
+		__m256d va = _mm256_set1_pd(a);
+		std::size_t i = 0;
+		for (; i + 4 <= n; i += 4)
+			_mm256_storeu_pd(y + i, _mm256_mul_pd(_mm256_loadu_pd(y + i), va));
+		for (; i < n; ++i)
+			y[i] *= a;
+	}
+
+	LISCRIPT_AVX2 void axpy_avx2(double* y, double a, const double* x, std::size_t n)
+	{
+		__m256d va = _mm256_set1_pd(a);
+		std::size_t i = 0;
+		for (; i + 4 <= n; i += 4)
+			_mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_loadu_pd(y + i), _mm256_mul_pd(va, _mm256_loadu_pd(x + i))));
+		for (; i < n; ++i)
+			y[i] += a * x[i];
+	}
+#endif
+
+	struct mul_op
+	{
+		static double scalar(double a, double b) { return a * b; }
+#ifdef LISCRIPT_SIMD
+		LISCRIPT_AVX2 static __m256d vector(__m256d a, __m256d b) { return _mm256_mul_pd(a, b); }
+#endif
+	};
+
+	template <typename Op>
+	double reduce_f64(const double* x, std::size_t n, double init)
+	{
+#ifdef LISCRIPT_SIMD
+		if (has_avx2())
+			return reduce_avx2<Op>(x, n, init);
+#endif
+		return reduce_scalar<Op>(x, n, init);
+	}
+
+	double dot_f64(const double* x, const double* y, std::size_t n)
+	{
+#ifdef LISCRIPT_SIMD
+		if (has_avx2())
+			return dot_avx2(x, y, n);
+#endif
+		return dot_scalar(x, y, n);
+	}
+
+	template <typename Op>
+	void elementwise_f64(double* y, const double* x, std::size_t n)
+	{
+#ifdef LISCRIPT_SIMD
+		if (has_avx2())
+			return elementwise_avx2<Op>(y, x, n);
+#endif
+		for (std::size_t i = 0; i < n; ++i)
+			y[i] = Op::scalar(y[i], x[i]);
+	}
+
+	void scale_f64(double* y, double a, std::size_t n)
+	{
+#ifdef LISCRIPT_SIMD
+		if (has_avx2())
+			return scale_avx2(y, a, n);
+#endif
+		for (std::size_t i = 0; i < n; ++i)
+			y[i] *= a;
+	}
+
+	void axpy_f64(double* y, double a, const double* x, std::size_t n)
+	{
+#ifdef LISCRIPT_SIMD
+		if (has_avx2())
+			return axpy_avx2(y, a, x, n);
+#endif
+		for (std::size_t i = 0; i < n; ++i)
+			y[i] += a * x[i];
+	}
+
+	s_typed_array* this_typed_array(variable this_var)
+	{
+		if (this_var.type != var_type::object)
+			throw not_array_error();
+		if (this_var.v_object == nullptr)
+			throw null_reference_error();
+		if (this_var.v_object->type != object_type::typed_array)
+			throw not_array_error();
+		return (s_typed_array*)this_var.v_object;
+	}
+
+	//  ׸ type  typed array Դϴ.
+	s_typed_array* operand_typed_array(variable v, const s_typed_array* like)
+	{
+		if (v.type != var_type::object || v.v_object == nullptr || v.v_object->type != object_type::typed_array)
+			throw invalid_arg_error();
+		s_typed_array* arr = (s_typed_array*)v.v_object;
+		if (arr->element != like->element || arr->size != like->size)
+			throw invalid_arg_error();
+		return arr;
+	}
+
+	variable load_element(s_typed_array* arr, std::size_t i)
+	{
+		if (arr->element == element_type::float64)
+			return variable::number(arr->f64()[i]);
+		return variable::number(arr->i32()[i]);
+	}
+
+	// Int32Array int32     ֽϴ.
+	void store_element(s_typed_array* arr, std::size_t i, variable v)
+	{
+		if (v.type != var_type::number)
+			throw invalid_arg_error();
+
+		if (arr->element == element_type::float64)
+		{
+			arr->f64()[i] = v.v_number;
+			return;
+		}
+
+		double intpart;
+		if (std::modf(v.v_number, &intpart) != 0.0)
+			throw invalid_arg_error();
+		if (intpart < INT32_MIN || intpart > INT32_MAX)
+			throw out_of_range_error();
+		arr->i32()[i] = static_cast<std::int32_t>(intpart);
+	}
+
+	// float64Array, int32Array ڴ , Array, typed array  ϳԴϴ.
+	variable typed_array_from(element_type element, s_array* arguments)
+	{
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		variable source = arguments->vector[0];
+
+		if (source.type == var_type::number)
+		{
+			std::size_t size = to_array_position(source, max_array_length);
+			return variable::object(create_typed_array(element, size)->obj());
+		}
+
+		if (source.type != var_type::object)
+			throw invalid_arg_error();
+		if (source.v_object == nullptr)
+			throw null_reference_error();
+
+		if (source.v_object->type == object_type::array)
+		{
+			s_array* src = (s_array*)source.v_object;
+			s_typed_array* arr = create_typed_array(element, src->size());
+			for (std::size_t i = 0; i < arr->size; ++i)
+				store_element(arr, i, src->get(i));
+			return variable::object(arr->obj());
+		}
+		if (source.v_object->type == object_type::typed_array)
+		{
+			s_typed_array* src = (s_typed_array*)source.v_object;
+			s_typed_array* arr = create_typed_array(element, src->size);
+			for (std::size_t i = 0; i < arr->size; ++i)
+				store_element(arr, i, load_element(src, i));
+			return variable::object(arr->obj());
+		}
+		throw invalid_arg_error();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ *  kernel
+ * parallelSum, parallelMinMax, parallelReduce, parallelMap  迭 parallel_chunk   thread pool óմϴ.
+ *     ġǷ thread      ϴ.
+ * worker thread GC ϵ Ƿ GC  Ҵϰų interpreter ¸ ǵ帮 ʰ, ׸ ϸ а ϴ.
+ * ȣ thread     ٸǷ  ̿ GC ų 迭 ٲ ʽϴ.
+ **/
+
+namespace
+{
+	// ȣ thread worker hardware thread ϳ ϴ work-stealing poolԴϴ.
+	//  ڱ queue ڿ task ,  ٸ queue տ Ŀɴϴ.
+	class thread_pool
+	{
+	public:
+		static thread_pool& instance()
+		{
+			static thread_pool pool;
+			return pool;
+		}
+
+		// 0 count - 1 task fn(i)   θ    ٸϴ.
+		template <typename Fn>
+		void run(std::size_t count, Fn& fn)
+		{
+			if (workers_.empty() || count <= 1)
+			{
+				for (std::size_t i = 0; i < count; ++i)
+					fn(i);
+				return;
+			}
+
+			task_fn_ = [](void* ctx, std::size_t i) { (*static_cast<Fn*>(ctx))(i); };
+			task_ctx_ = &fn;
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				remaining_ = count;
+			}
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				queue& q = *queues_[i % queues_.size()];
+				std::lock_guard<std::mutex> lock(q.mutex);
+				q.tasks.push_back(i);
+			}
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				++generation_;
+			}
+			wake_.notify_all();
+
+			// ȣ thread  queue ýϴ.
+			work(queues_.size() - 1);
+
+			std::unique_lock<std::mutex> lock(mutex_);
+			done_.wait(lock, [this] { return remaining_ == 0; });
+		}
+
+	private:
+		struct queue
+		{
+			std::mutex mutex;
+			std::deque<std::size_t> tasks;
+		};
+
+		thread_pool()
+		{
+			std::size_t participants = std::max(std::thread::hardware_concurrency(), 1u);
+			for (std::size_t i = 0; i < participants; ++i)
+				queues_.emplace_back(new queue());
+			for (std::size_t i = 0; i + 1 < participants; ++i)
+				workers_.emplace_back(&thread_pool::worker_main, this, i);
+		}
+
+		~thread_pool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				stop_ = true;
+			}
+			wake_.notify_all();
+			for (std::thread& t : workers_)
+				t.join();
+		}
+
+		void worker_main(std::size_t index)
+		{
+			std::uint64_t seen = 0;
+			for (;;)
+			{
+				{
+					std::unique_lock<std::mutex> lock(mutex_);
+					wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+					if (stop_)
+						return;
+					seen = generation_;
+				}
+				work(index);
+			}
+		}
+
+		void work(std::size_t index)
+		{
+			std::size_t task;
+			while (take(index, task))
+			{
+				task_fn_(task_ctx_, task);
+
+				std::lock_guard<std::mutex> lock(mutex_);
+				if (--remaining_ == 0)
+					done_.notify_all();
+			}
+		}
+
+		bool take(std::size_t index, std::size_t& task)
+		{
+			{
+				queue& own = *queues_[index];
+				std::lock_guard<std::mutex> lock(own.mutex);
+				if (!own.tasks.empty())
+				{
+					task = own.tasks.back();
+					own.tasks.pop_back();
+					return true;
+				}
+			}
+			for (std::size_t k = 1; k < queues_.size(); ++k)
+			{
+				queue& victim = *queues_[(index + k) % queues_.size()];
+				std::lock_guard<std::mutex> lock(victim.mutex);
+				if (!victim.tasks.empty())
+				{
+					task = victim.tasks.front();
+					victim.tasks.pop_front();
+					return true;
+				}
+			}
+			return false;
+		}
+
+		std::vector<std::unique_ptr<queue>> queues_;
+		std::vector<std::thread> workers_;
+
+		std::mutex mutex_;
+		std::condition_variable wake_;
+		std::condition_variable done_;
+		std::uint64_t generation_ = 0;
+		std::size_t remaining_ = 0;
+		bool stop_ = false;
+
+		void (*task_fn_)(void*, std::size_t) = nullptr;
+		void* task_ctx_ = nullptr;
+	};
+
+	const std::size_t parallel_chunk = 1 << 16;
+
+	std::size_t chunk_count(std::size_t size)
+	{
+		return (size + parallel_chunk - 1) / parallel_chunk;
+	}
+
+	//  kernel д  迭Դϴ.   ϳ nullptr ƴմϴ.
+	struct numeric_source
+	{
+		const double* f64;
+		const std::int32_t* i32;
+		const variable* vars;
+		std::size_t size;
+	};
+
+	numeric_source this_numeric_source(variable this_var)
+	{
+		if (this_var.type != var_type::object)
+			throw not_array_error();
+		if (this_var.v_object == nullptr)
+			throw null_reference_error();
+
+		numeric_source src = { nullptr, nullptr, nullptr, 0 };
+		if (this_var.v_object->type == object_type::typed_array)
+		{
+			s_typed_array* arr = (s_typed_array*)this_var.v_object;
+			if (arr->element == element_type::float64)
+				src.f64 = arr->f64();
+			else
+				src.i32 = arr->i32();
+			src.size = arr->size;
+			return src;
+		}
+		if (this_var.v_object->type != object_type::array)
+			throw not_array_error();
+
+		s_array* arr = (s_array*)this_var.v_object;
+		switch (arr->kind)
+		{
+		case elements_kind::packed_int:
+			src.i32 = arr->ints.data();
+			break;
+		case elements_kind::packed_double:
+			src.f64 = arr->doubles.data();
+			break;
+		default:
+			src.vars = arr->vector.data();
+			break;
+		}
+		src.size = arr->size();
+		return src;
+	}
+
+	// [begin, end) ׸ double out űϴ. generic 迭 number ƴ ׸  falseԴϴ.
+	bool load_chunk(const numeric_source& src, std::size_t begin, std::size_t end, double* out)
+	{
+		if (src.i32 != nullptr)
+		{
+			std::copy(src.i32 + begin, src.i32 + end, out);
+			return true;
+		}
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			if (src.vars[i].type != var_type::number)
+				return false;
+			out[i - begin] = src.vars[i].v_number;
+		}
+		return true;
+	}
+
+	enum class reduce_op { sum, product, min, max };
+
+	reduce_op to_reduce_op(variable v)
+	{
+		if (v.type != var_type::object || v.v_object == nullptr || v.v_object->type != object_type::string)
+			throw invalid_arg_error();
+		const std::string op = to_std_string((s_string*)v.v_object);
+
+		if (op == "+")
+			return reduce_op::sum;
+		if (op == "*")
+			return reduce_op::product;
+		if (op == "min")
+			return reduce_op::min;
+		if (op == "max")
+			return reduce_op::max;
+		throw invalid_arg_error();
+	}
+
+	double reduce_chunk(reduce_op op, const double* x, std::size_t n)
+	{
+		switch (op)
+		{
+		case reduce_op::sum:
+			return reduce_f64<sum_op>(x, n, 0.0);
+		case reduce_op::product:
+			return reduce_f64<mul_op>(x, n, 1.0);
+		case reduce_op::min:
+			return reduce_f64<min_op>(x, n, x[0]);
+		default:
+			return reduce_f64<max_op>(x, n, x[0]);
+		}
+	}
+
+	double combine(reduce_op op, double a, double b)
+	{
+		switch (op)
+		{
+		case reduce_op::sum:
+			return sum_op::scalar(a, b);
+		case reduce_op::product:
+			return mul_op::scalar(a, b);
+		case reduce_op::min:
+			return min_op::scalar(a, b);
+		default:
+			return max_op::scalar(a, b);
+		}
+	}
+
+	// Int32Array  sum()  int64 Ȯϰ մϴ.
+	std::int64_t parallel_int_sum(const std::int32_t* x, std::size_t size)
+	{
+		std::vector<std::int64_t> partial(chunk_count(size));
+		auto task = [&](std::size_t c) {
+			std::size_t begin = c * parallel_chunk, end = std::min(size, begin + parallel_chunk);
+			std::int64_t sum = 0;
+			for (std::size_t i = begin; i < end; ++i)
+				sum += x[i];
+			partial[c] = sum;
+		};
+		thread_pool::instance().run(partial.size(), task);
+
+		std::int64_t sum = 0;
+		for (std::int64_t s : partial)
+			sum += s;
+		return sum;
+	}
+
+	// ops 긶      Ĩϴ.
+	template <std::size_t N>
+	void parallel_reduce(const numeric_source& src, const reduce_op (&ops)[N], double (&result)[N])
+	{
+		std::size_t chunks = chunk_count(src.size);
+		std::vector<double> partial(chunks * N);
+		std::vector<char> not_number(chunks, 0);
+
+		auto task = [&](std::size_t c) {
+			std::size_t begin = c * parallel_chunk, end = std::min(src.size, begin + parallel_chunk);
+			std::vector<double> buffer;
+			const double* x = src.f64 + begin;
+			if (src.f64 == nullptr)
+			{
+				buffer.resize(end - begin);
+				if (!load_chunk(src, begin, end, buffer.data()))
+				{
+					not_number[c] = 1;
+					return;
+				}
+				x = buffer.data();
+			}
+			for (std::size_t k = 0; k < N; ++k)
+				partial[c * N + k] = reduce_chunk(ops[k], x, end - begin);
+		};
+		thread_pool::instance().run(chunks, task);
+
+		if (std::find(not_number.begin(), not_number.end(), 1) != not_number.end())
+			throw not_number_error();
+		for (std::size_t k = 0; k < N; ++k)
+		{
+			result[k] = partial[k];
+			for (std::size_t c = 1; c < chunks; ++c)
+				result[k] = combine(ops[k], result[k], partial[c * N + k]);
+		}
+	}
+
+	enum class map_op { add, sub, mul, div };
+
+	// y[i] = x[i] op operand  մϴ.
+	void parallel_map(const numeric_source& src, map_op op, double operand, double* y)
+	{
+		std::size_t chunks = chunk_count(src.size);
+		std::vector<char> not_number(chunks, 0);
+
+		auto task = [&](std::size_t c) {
+			std::size_t begin = c * parallel_chunk, end = std::min(src.size, begin + parallel_chunk);
+			if (src.f64 != nullptr)
+				std::copy(src.f64 + begin, src.f64 + end, y + begin);
+			else if (!load_chunk(src, begin, end, y + begin))
+			{
+				not_number[c] = 1;
+				return;
+			}
+
+			double* out = y + begin;
+			std::size_t n = end - begin;
+			switch (op)
+			{
+			case map_op::add:
+				for (std::size_t i = 0; i < n; ++i)
+					out[i] += operand;
+				break;
+			case map_op::sub:
+				for (std::size_t i = 0; i < n; ++i)
+					out[i] -= operand;
+				break;
+			case map_op::mul:
+				scale_f64(out, operand, n);
+				break;
+			case map_op::div:
+				for (std::size_t i = 0; i < n; ++i)
+					out[i] /= operand;
+				break;
+			}
+		};
+		thread_pool::instance().run(chunks, task);
+
+		if (std::find(not_number.begin(), not_number.end(), 1) != not_number.end())
+			throw not_number_error();
+	}
+
+	map_op to_map_op(variable v)
+	{
+		if (v.type != var_type::object || v.v_object == nullptr || v.v_object->type != object_type::string)
+			throw invalid_arg_error();
+		const std::string op = to_std_string((s_string*)v.v_object);
+
+		if (op == "+")
+			return map_op::add;
+		if (op == "-")
+			return map_op::sub;
+		if (op == "*")
+			return map_op::mul;
+		if (op == "/")
+			return map_op::div;
+		throw invalid_arg_error();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Map hash table
+ * flat hash table(flat hash table  ) key value slot  ϴ.
+ *  ְų  slot 7/8  rehashմϴ.  slot ٸ ũ⸦ ø ʰ  ϰ ˴ϴ.
+ * number key (0 -0, NaN  key), string key ,  object ּҷ մϴ.
+ **/
+
+namespace
+{
+	const std::size_t map_npos = static_cast<std::size_t>(-1);
+
+	std::uint64_t key_hash(variable key)
+	{
+		std::uint64_t h = 0;
+		switch (key.type)
+		{
+		case var_type::number:
+		{
+			double d = key.v_number;
+			if (d == 0.0)
+				d = 0.0;
+			else if (std::isnan(d))
+				d = std::numeric_limits<double>::quiet_NaN();
+			std::memcpy(&h, &d, sizeof(h));
+			break;
+		}
+		case var_type::boolean:
+			h = key.v_boolean ? 1 : 0;
+			break;
+		case var_type::undefined:
+			break;
+		case var_type::object:
+			if (key.v_object != nullptr && key.v_object->type == object_type::string)
+				h = pstr_hash()((s_string*)key.v_object);
+			else
+				h = reinterpret_cast<std::uintptr_t>(key.v_object);
+			break;
+		}
+		return mix_hash(h ^ static_cast<std::uint64_t>(key.type));
+	}
+
+	bool key_equal(variable a, variable b)
+	{
+		if (a.type != b.type)
+			return false;
+
+		switch (a.type)
+		{
+		case var_type::number:
+			return a.v_number == b.v_number || (std::isnan(a.v_number) && std::isnan(b.v_number));
+		case var_type::boolean:
+			return a.v_boolean == b.v_boolean;
+		case var_type::undefined:
+			return true;
+		default:
+			if (a.v_object == b.v_object)
+				return true;
+			if (a.v_object == nullptr || b.v_object == nullptr)
+				return false;
+			return a.v_object->type == object_type::string && b.v_object->type == object_type::string
+				&& pstr_equal()((s_string*)a.v_object, (s_string*)b.v_object);
+		}
+	}
+
+	// key  slot ġԴϴ.  map_nposԴϴ.
+	std::size_t map_find(const s_map* map, variable key, std::uint64_t hash)
+	{
+		if (map->slots.empty())
+			return map_npos;
+
+		std::uint8_t tag = hash_tag(hash);
+		for (probe_seq seq(hash, map->slots.size()); ; seq.next())
+		{
+			const std::uint8_t* group = map->ctrl.data() + seq.offset();
+			for (std::uint32_t m = match_ctrl(group, tag); m != 0; m &= m - 1)
+			{
+				std::size_t i = seq.offset() + lowest_bit(m);
+				if (key_equal(map->slots[i].key, key))
+					return i;
+			}
+			if (match_ctrl(group, ctrl_empty) != 0)
+				return map_npos;
+		}
+	}
+
+	// hash ó  ų  slotԴϴ.  7/8 ̹Ƿ ׻ ֽϴ.
+	std::size_t map_find_free(const s_map* map, std::uint64_t hash)
+	{
+		for (probe_seq seq(hash, map->slots.size()); ; seq.next())
+		{
+			std::uint32_t m = match_free(map->ctrl.data() + seq.offset());
+			if (m != 0)
+				return seq.offset() + lowest_bit(m);
+		}
+	}
+
+	// ׸ count ־  7/16  ũ ٽ ϴ.
+	void map_rehash(s_map* map, std::size_t count)
+	{
+		std::size_t capacity = hash_group_width;
+		while (count * 16 > capacity * 7)
+			capacity *= 2;
+
+		gc_atomic_vector<std::uint8_t> old_ctrl;
+		gc_vector<map_slot> old_slots;
+		old_ctrl.swap(map->ctrl);
+		old_slots.swap(map->slots);
+		map->ctrl.assign(capacity, ctrl_empty);
+		map->slots.assign(capacity, map_slot { variable::undefined(), variable::undefined() });
+
+		for (std::size_t i = 0; i < old_slots.size(); ++i)
+		{
+			if (old_ctrl[i] & 0x80)
+				continue;
+			std::uint64_t hash = key_hash(old_slots[i].key);
+			std::size_t j = map_find_free(map, hash);
+			map->ctrl[j] = hash_tag(hash);
+			map->slots[j] = old_slots[i];
+		}
+		map->deleted = 0;
+	}
+
+	variable map_get(const s_map* map, variable key)
+	{
+		std::size_t i = map_find(map, key, key_hash(key));
+		return i == map_npos ? variable::undefined() : map->slots[i].value;
+	}
+
+	void map_set(s_map* map, variable key, variable value)
+	{
+		std::uint64_t hash = key_hash(key);
+		std::size_t i = map_find(map, key, hash);
+		if (i != map_npos)
+		{
+			map->slots[i].value = value;
+			return;
+		}
+
+		if ((map->size + map->deleted + 1) * 8 > map->slots.size() * 7)
+			map_rehash(map, map->size + 1);
+
+		i = map_find_free(map, hash);
+		if (map->ctrl[i] == ctrl_deleted)
+			--map->deleted;
+		map->ctrl[i] = hash_tag(hash);
+		map->slots[i].key = key;
+		map->slots[i].value = value;
+		++map->size;
+	}
+
+	bool map_erase(s_map* map, variable key)
+	{
+		std::size_t i = map_find(map, key, key_hash(key));
+		if (i == map_npos)
+			return false;
+
+		// group  slot ־ٸ  group ãⰡ  ̹Ƿ ٴ ǥ   ˴ϴ.
+		const std::uint8_t* group = map->ctrl.data() + (i & ~(hash_group_width - 1));
+		if (match_ctrl(group, ctrl_empty) != 0)
+		{
+			map->ctrl[i] = ctrl_empty;
+		}
+		else
+		{
+			map->ctrl[i] = ctrl_deleted;
+			++map->deleted;
+		}
+		map->slots[i].key = variable::undefined();
+		map->slots[i].value = variable::undefined();
+		--map->size;
+		return true;
+	}
+
+	//  ִ slot fn(slot) θϴ.  slot ̸   ϴ.
+	template <typename Fn>
+	void map_for_each(const s_map* map, Fn fn)
+	{
+		for (std::size_t i = 0; i < map->slots.size(); ++i)
+		{
+			if ((map->ctrl[i] & 0x80) == 0)
+				fn(map->slots[i]);
+		}
+	}
+
+	s_map* this_map(variable this_var)
+	{
+		if (this_var.type != var_type::object)
+			throw not_object_error();
+		if (this_var.v_object == nullptr)
+			throw null_reference_error();
+		if (this_var.v_object->type != object_type::map)
+			throw not_object_error();
+		return (s_map*)this_var.v_object;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * StringBuilder
+ * buffer std::vectoró  þǷ append ̴ ̸ŭ ð ɸϴ.
+ * toString buffer s_string ϳ ϰ   flat ܵӴϴ. append clear flat ϴ.
+ **/
+
+namespace
+{
+	// number ٽ о    ǵ 15ڸ, ڶ 17ڸ Դϴ. 15ڸ    ϴ.
+	void builder_append_number(gc_atomic_vector<char>& buffer, double d)
+	{
+		char buf[32];
+		int len = std::snprintf(buf, sizeof(buf), "%.15g", d);
+		if (std::isfinite(d) && std::strtod(buf, nullptr) != d)
+			len = std::snprintf(buf, sizeof(buf), "%.17g", d);
+		buffer.insert(buffer.end(), buf, buf + len);
+	}
+
+	void builder_append(s_string_builder* builder, variable value)
+	{
+		gc_atomic_vector<char>& buffer = builder->buffer;
+
+		switch (value.type)
+		{
+		case var_type::undefined:
+		{
+			static const char text[] = "undefined";
+			buffer.insert(buffer.end(), text, text + sizeof(text) - 1);
+			break;
+		}
+		case var_type::boolean:
+		{
+			const char* text = value.v_boolean ? "true" : "false";
+			buffer.insert(buffer.end(), text, text + std::strlen(text));
+			break;
+		}
+		case var_type::number:
+			builder_append_number(buffer, value.v_number);
+			break;
+		case var_type::object:
+			if (value.v_object == nullptr)
+			{
+				static const char text[] = "null";
+				buffer.insert(buffer.end(), text, text + sizeof(text) - 1);
+			}
+			else if (value.v_object->type == object_type::string)
+			{
+				s_string* str = (s_string*)value.v_object;
+				buffer.insert(buffer.end(), str->ptr, str->ptr + str->size);
+			}
+			else if (value.v_object->type == object_type::string_builder)
+			{
+				// ڱ ڽ   Ƿ buffer ø  other ġ нϴ.
+				const gc_atomic_vector<char>& other = ((s_string_builder*)value.v_object)->buffer;
+				std::size_t count = other.size();
+				buffer.resize(buffer.size() + count);
+				if (count != 0)
+					std::memcpy(buffer.data() + buffer.size() - count, other.data(), count);
+			}
+			else
+			{
+				throw invalid_arg_error();
+			}
+			break;
+		default:
+			throw invalid_arg_error();
+		}
+	}
+
+	s_string* builder_flatten(s_string_builder* builder)
+	{
+		if (builder->flat == nullptr)
+			builder->flat = create_string(builder->buffer.data(), builder->buffer.size());
+		return builder->flat;
+	}
+
+	s_string_builder* this_string_builder(variable this_var)
+	{
+		if (this_var.type != var_type::object)
+			throw not_object_error();
+		if (this_var.v_object == nullptr)
+			throw null_reference_error();
+		if (this_var.v_object->type != object_type::string_builder)
+			throw not_object_error();
+		return (s_string_builder*)this_var.v_object;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * string ˻
+ * substring, split, trim ִ string create_slice   string buffer ״ ŵϴ.
+ * find_bytes needle ù byte  byte  ´ ġ 16byte      ġ memcmpմϴ.
+ * x86-64 SSE2 ,  κа ٸ ȯ濡 memchr ù byte ãϴ.  byte¥ needle memchr ϴ.
+ **/
+
+namespace
+{
+	const std::size_t string_npos = static_cast<std::size_t>(-1);
+
+	// haystack[from, size) needle ó  ġԴϴ. ٸ string_nposԴϴ.
+	std::size_t find_bytes(const char* haystack, std::size_t size, const char* needle, std::size_t length, std::size_t from)
+	{
+		if (length == 0)
+			return from;
+		if (length > size || from > size - length)
+			return string_npos;
+
+		// needle   ִ  ġԴϴ.
+		const char* last = haystack + size - length;
+		const char* p = haystack + from;
+
+		if (length == 1)
+		{
+			const void* found = std::memchr(p, needle[0], last - p + 1);
+			return (found != nullptr) ? (const char*)found - haystack : string_npos;
+		}
+
+#ifdef LISCRIPT_SIMD
+		const __m128i first = _mm_set1_epi8(needle[0]);
+		const __m128i tail = _mm_set1_epi8(needle[length - 1]);
+		for (; last - p + 1 >= 16; p += 16)
+		{
+			__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + length - 1));
+			std::uint32_t mask = static_cast<std::uint32_t>(
+				_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, tail))));
+			while (mask != 0)
+			{
+				std::size_t i = lowest_bit(mask);
+				if (std::memcmp(p + i + 1, needle + 1, length - 2) == 0)
+					return p + i - haystack;
+				mask &= mask - 1;
+			}
+		}
+#endif
+		while (p <= last)
+		{
+			p = (const char*)std::memchr(p, needle[0], last - p + 1);
+			if (p == nullptr)
+				break;
+			if (std::memcmp(p + 1, needle + 1, length - 1) == 0)
+				return p - haystack;
+			++p;
+		}
+		return string_npos;
+	}
+
+	bool is_space(char ch)
+	{
+		return ch == ' ' || (ch >= '\t' && ch <= '\r');
+	}
+
+	s_string* this_string(variable this_var)
+	{
+		if (this_var.type != var_type::object)
+			throw not_string_error();
+		if (this_var.v_object == nullptr)
+			throw null_reference_error();
+		if (this_var.v_object->type != object_type::string)
+			throw not_string_error();
+		return (s_string*)this_var.v_object;
+	}
+
+	s_string* string_arg(variable v)
+	{
+		if (v.type != var_type::object || v.v_object == nullptr || v.v_object->type != object_type::string)
+			throw not_string_error();
+		return (s_string*)v.v_object;
+	}
+}
+
+void init_scripting()
+{
+	GC_INIT();
+	GC_set_finalize_on_demand(0/*false*/);
+
+	empty_expr.type = expr_type::list;
+
+	// prototype objects
+	p_Object = allocate_object();
+	p_Object->proto = nullptr;
+
+	p_Function = allocate_object();
+	p_Function->proto = p_Object;
+
+	p_String = allocate_object();
+	p_String->proto = p_Object;
+
+	p_Array = allocate_object();
+	p_Array->proto = p_Object;
+
+	p_Float64Array = allocate_object();
+	p_Float64Array->proto = p_Object;
+
+	p_Int32Array = allocate_object();
+	p_Int32Array->proto = p_Object;
+
+	p_RecordArray = allocate_object();
+	p_RecordArray->proto = p_Object;
+
+	p_Map = allocate_object();
+	p_Map->proto = p_Object;
+
+	p_StringBuilder = allocate_object();
+	p_StringBuilder->proto = p_Object;
+
+	// cached strings
+	str_empty = allocate_string("");
+	str_empty->_obj.proto = p_String;
+
+	s_string* str_object = create_string("Object");
+	s_string* str_function = create_string("Function");
+	s_string* str_string = create_string("String");
+	s_string* str_array = create_string("Array");
+	s_string* str_float64array = create_string("Float64Array");
+	s_string* str_int32array = create_string("Int32Array");
+	s_string* str_recordarray = create_string("RecordArray");
+	s_string* str_map = create_string("Map");
+	s_string* str_stringbuilder = create_string("StringBuilder");
+	s_string* str_index = create_string("index");
+	s_string* str_val = create_string("val");
+	s_string* str_str = create_string("str");
+	s_string* str_path = create_string("path");
+	s_string* str_name = create_string("name");
+	s_string* str_fn = create_string("fn");
+	s_string* str_capacity = create_string("capacity");
+	s_string* str_begin = create_string("begin");
+	s_string* str_end = create_string("end");
+	s_string* str_other = create_string("other");
+	s_string* str_compare = create_string("compare");
+	s_string* str_factor = create_string("factor");
+	s_string* str_source = create_string("source");
+	s_string* str_op = create_string("op");
+	s_string* str_operand = create_string("operand");
+	s_string* str_ctor = create_string("ctor");
+	s_string* str_record = create_string("record");
+	s_string* str_field = create_string("field");
+	s_string* str_key = create_string("key");
+	s_string* str_value = create_string("value");
+	s_string* str_search = create_string("search");
+	s_string* str_from = create_string("from");
+	s_string* str_prefix = create_string("prefix");
+	s_string* str_separator = create_string("separator");
+	str_prototype = create_string("prototype");
+	str_replconfig = create_string("replConfig");
+	str_dumpexpr = create_string("dumpExpr");
+	str_profilealloc = create_string("profileAlloc");
+	str_tierlog = create_string("tierLog");
+	str_warmthreshold = create_string("warmThreshold");
+	str_jitthreshold = create_string("jitThreshold");
+
+	p_Object->name = str_object;
+	p_Function->name = str_function;
+	p_String->name = str_string;
+	p_Array->name = str_array;
+	p_Float64Array->name = str_float64array;
+	p_Int32Array->name = str_int32array;
+	p_RecordArray->name = str_recordarray;
+	p_Map->name = str_map;
+	p_StringBuilder->name = str_stringbuilder;
+
+	// constructor objects
+	static auto empty_ctor = make_function_template({ }, empty_expr);
+
+	f_Object = create_function(empty_ctor.get(), nullptr)->obj();
+	f_Object->vars[str_prototype] = variable::object(p_Object);
+
+	f_Function = create_function(empty_ctor.get(), nullptr)->obj();
+	f_Function->vars[str_prototype] = variable::object(p_Function);
+
+	f_String = create_function(empty_ctor.get(), nullptr)->obj();
+	f_String->vars[str_prototype] = variable::object(p_String);
+
+	f_Array = create_function(empty_ctor.get(), nullptr)->obj();
+	f_Array->vars[str_prototype] = variable::object(p_Array);
+
+	f_Float64Array = create_function(empty_ctor.get(), nullptr)->obj();
+	f_Float64Array->vars[str_prototype] = variable::object(p_Float64Array);
+
+	f_Int32Array = create_function(empty_ctor.get(), nullptr)->obj();
+	f_Int32Array->vars[str_prototype] = variable::object(p_Int32Array);
+
+	f_RecordArray = create_function(empty_ctor.get(), nullptr)->obj();
+	f_RecordArray->vars[str_prototype] = variable::object(p_RecordArray);
+
+	// new Map construct_object() s_map ϴ.
+	f_Map = create_function(empty_ctor.get(), nullptr)->obj();
+	f_Map->vars[str_prototype] = variable::object(p_Map);
+
+	// new StringBuilder construct_object() s_string_builder ϴ.
+	f_StringBuilder = create_function(empty_ctor.get(), nullptr)->obj();
+	f_StringBuilder->vars[str_prototype] = variable::object(p_StringBuilder);
+
+	// array
+	native_fn_t array_size = [](variable this_var, s_array* arguments) {
+		if (this_var.type != var_type::object)
+			throw not_array_error();
+		if (this_var.v_object == nullptr)
+			throw null_reference_error();
+		if (this_var.v_object->type != object_type::array)
+			throw not_array_error();
+		s_array* arr = (s_array*)this_var.v_object;
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+
+		return variable::number(arr->size());
+	};
+	native_fn_t array_get = [](variable this_var, s_array* arguments) {
+		if (this_var.type != var_type::object)
+			throw not_array_error();
+		if (this_var.v_object == nullptr)
+			throw null_reference_error();
+		if (this_var.v_object->type != object_type::array)
+			throw not_array_error();
+		s_array* arr = (s_array*)this_var.v_object;
+
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		if (arguments->vector[0].type != var_type::number)
+			throw invalid_arg_error();
+		try
+		{
+			std::size_t idx = static_cast<std::size_t>(to_integer(arguments->vector[0].v_number));
+			if (idx >= arr->size())
+				throw out_of_range_error();
+			return arr->get(idx);
+		}
+		catch (not_integer_error&)
+		{
+			throw invalid_arg_error();
+		}
+	};
+	native_fn_t array_set = [](variable this_var, s_array* arguments) {
+		if (this_var.type != var_type::object)
+			throw not_array_error();
+		if (this_var.v_object == nullptr)
+			throw null_reference_error();
+		if (this_var.v_object->type != object_type::array)
+			throw not_array_error();
+		s_array* arr = (s_array*)this_var.v_object;
+
+		if (arguments->vector.size() != 2)
+			throw invalid_arg_error();
+		if (arguments->vector[0].type != var_type::number)
+			throw invalid_arg_error();
+		try
+		{
+			std::size_t idx = static_cast<std::size_t>(to_integer(arguments->vector[0].v_number));
+			if (idx >= arr->size())
+				throw out_of_range_error();
+			arr->set(idx, arguments->vector[1]);
+			return arguments->vector[1];
+		}
+		catch (not_integer_error&)
+		{
+			throw invalid_arg_error();
+		}
+	};
+	native_fn_t array_push = [](variable this_var, s_array* arguments) {
+		s_array* arr = this_array(this_var);
+
+		for (variable v : arguments->vector)
+			arr->push_back(v);
+		return variable::number(arr->size());
+	};
+	native_fn_t array_pop = [](variable this_var, s_array* arguments) {
+		s_array* arr = this_array(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		if (arr->size() == 0)
+			throw out_of_range_error();
+
+		variable ret = arr->get(arr->size() - 1);
+		arr->pop_back();
+		return ret;
+	};
+	native_fn_t array_reserve = [](variable this_var, s_array* arguments) {
+		s_array* arr = this_array(this_var);
+
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		arr->reserve(to_array_position(arguments->vector[0], max_array_length));
+		return variable::undefined();
+	};
+	native_fn_t array_slice = [](variable this_var, s_array* arguments) {
+		s_array* arr = this_array(this_var);
+
+		if (arguments->vector.size() < 1 || arguments->vector.size() > 2)
+			throw invalid_arg_error();
+		std::size_t size = arr->size();
+		std::size_t end = size;
+		if (arguments->vector.size() == 2)
+			end = to_array_position(arguments->vector[1], size);
+		std::size_t begin = to_array_position(arguments->vector[0], end);
+
+		s_array* ret = create_array(arr->kind);
+		ret->append(arr, begin, end);
+		return variable::object(ret->obj());
+	};
+	native_fn_t array_concat = [](variable this_var, s_array* arguments) {
+		s_array* arr = this_array(this_var);
+
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		variable other = arguments->vector[0];
+		if (other.type != var_type::object || other.v_object == nullptr || other.v_object->type != object_type::array)
+			throw invalid_arg_error();
+		s_array* rhs = (s_array*)other.v_object;
+
+		s_array* ret = create_array(std::max(arr->kind, rhs->kind));
+		ret->reserve(arr->size() + rhs->size());
+		ret->append(arr, 0, arr->size());
+		ret->append(rhs, 0, rhs->size());
+		return variable::object(ret->obj());
+	};
+	native_fn_t array_fill = [](variable this_var, s_array* arguments) {
+		s_array* arr = this_array(this_var);
+
+		if (arguments->vector.size() < 1 || arguments->vector.size() > 3)
+			throw invalid_arg_error();
+		std::size_t size = arr->size();
+		std::size_t end = size;
+		if (arguments->vector.size() == 3)
+			end = to_array_position(arguments->vector[2], size);
+		std::size_t begin = 0;
+		if (arguments->vector.size() >= 2)
+			begin = to_array_position(arguments->vector[1], end);
+
+		variable val = arguments->vector[0];
+		if (begin == end)
+			return this_var;
+		if (kind_of(val) > arr->kind)
+			arr->widen(kind_of(val));
+
+		switch (arr->kind)
+		{
+		case elements_kind::packed_int:
+			std::fill(arr->ints.begin() + begin, arr->ints.begin() + end, static_cast<std::int32_t>(val.v_number));
+			break;
+		case elements_kind::packed_double:
+			std::fill(arr->doubles.begin() + begin, arr->doubles.begin() + end, val.v_number);
+			break;
+		default:
+			std::fill(arr->vector.begin() + begin, arr->vector.begin() + end, val);
+			break;
+		}
+		return this_var;
+	};
+	native_fn_t array_indexof = [](variable this_var, s_array* arguments) {
+		s_array* arr = this_array(this_var);
+
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		variable val = arguments->vector[0];
+		for (std::size_t i = 0, n = arr->size(); i < n; ++i)
+		{
+			if (arr->get(i) == val)
+				return variable::number(static_cast<double>(i));
+		}
+		return variable::number(-1);
+	};
+	native_fn_t array_reverse = [](variable this_var, s_array* arguments) {
+		s_array* arr = this_array(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		std::reverse(arr->ints.begin(), arr->ints.end());
+		std::reverse(arr->doubles.begin(), arr->doubles.end());
+		std::reverse(arr->vector.begin(), arr->vector.end());
+		return this_var;
+	};
+	native_fn_t array_sort = [](variable this_var, s_array* arguments) {
+		s_array* arr = this_array(this_var);
+
+		if (arguments->vector.size() > 1)
+			throw invalid_arg_error();
+
+		if (arguments->vector.empty())
+		{
+			//  Լ  number  մϴ. packed 迭 ˻  ٷ մϴ.
+			if (arr->kind == elements_kind::packed_int)
+			{
+				introsort(arr->ints.data(), arr->ints.size(), [](std::int32_t a, std::int32_t b) { return a < b; });
+				return this_var;
+			}
+			if (arr->kind == elements_kind::packed_double)
+			{
+				introsort(arr->doubles.data(), arr->doubles.size(), [](double a, double b) { return a < b; });
+				return this_var;
+			}
+
+			for (const variable& v : arr->vector)
+			{
+				if (v.type != var_type::number)
+					throw not_number_error();
+			}
+			introsort(arr->vector.data(), arr->vector.size(), [](variable a, variable b) {
+				return a.v_number < b.v_number;
+			});
+			return this_var;
+		}
+
+		variable cmp = arguments->vector[0];
+		if (cmp.type != var_type::object || cmp.v_object == nullptr || cmp.v_object->type != object_type::function)
+			throw not_function_error();
+		s_function* fn = (s_function*)cmp.v_object;
+
+		//  Լ 迭 ٲٰų ܸ   Ƿ 纻 ϰ  ٲ ֽϴ.
+		gc_vector<variable> sorted;
+		sorted.reserve(arr->size());
+		for (std::size_t i = 0, n = arr->size(); i < n; ++i)
+			sorted.push_back(arr->get(i));
+		introsort(sorted.data(), sorted.size(), [fn](variable a, variable b) {
+			s_array local_arguments;
+			s_array* args = prepare_arguments(fn, local_arguments);
+			args->vector.push_back(a);
+			args->vector.push_back(b);
+			return to_conditional(call_function(fn, variable::undefined(), args));
+		});
+		arr->assign(sorted.data(), sorted.size());
+		return this_var;
+	};
+	p_Array->vars[create_string("size")] = create_native_function({ }, array_size, false,
+		&array_length_epoch, intrinsic_kind::array_size)->var();
+	p_Array->vars[create_string("get")] = create_native_function({ str_index }, array_get, false,
+		nullptr, intrinsic_kind::array_get)->var();
+	p_Array->vars[create_string("set")] = create_native_function({ str_index, str_val }, array_set, false,
+		nullptr, intrinsic_kind::array_set)->var();
+	p_Array->vars[create_string("push")] = create_native_function({ }, array_push, true)->var();
+	p_Array->vars[create_string("pop")] = create_native_function({ }, array_pop)->var();
+	p_Array->vars[create_string("reserve")] = create_native_function({ str_capacity }, array_reserve)->var();
+	p_Array->vars[create_string("slice")] = create_native_function({ str_begin, str_end }, array_slice)->var();
+	p_Array->vars[create_string("concat")] = create_native_function({ str_other }, array_concat)->var();
+	p_Array->vars[create_string("fill")] = create_native_function({ str_val, str_begin, str_end }, array_fill)->var();
+	p_Array->vars[create_string("indexOf")] = create_native_function({ str_val }, array_indexof)->var();
+	p_Array->vars[create_string("reverse")] = create_native_function({ }, array_reverse)->var();
+	p_Array->vars[create_string("sort")] = create_native_function({ str_compare }, array_sort)->var();
+
+	// typed array
+	native_fn_t typed_size = [](variable this_var, s_array* arguments) {
+		s_typed_array* arr = this_typed_array(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		return variable::number(arr->size);
+	};
+	native_fn_t typed_get = [](variable this_var, s_array* arguments) {
+		s_typed_array* arr = this_typed_array(this_var);
+
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		if (arguments->vector[0].type != var_type::number)
+			throw invalid_arg_error();
+		try
+		{
+			std::size_t idx = static_cast<std::size_t>(to_integer(arguments->vector[0].v_number));
+			if (idx >= arr->size)
+				throw out_of_range_error();
+			return load_element(arr, idx);
+		}
+		catch (not_integer_error&)
+		{
+			throw invalid_arg_error();
+		}
+	};
+	native_fn_t typed_set = [](variable this_var, s_array* arguments) {
+		s_typed_array* arr = this_typed_array(this_var);
+
+		if (arguments->vector.size() != 2)
+			throw invalid_arg_error();
+		if (arguments->vector[0].type != var_type::number)
+			throw invalid_arg_error();
+		try
+		{
+			std::size_t idx = static_cast<std::size_t>(to_integer(arguments->vector[0].v_number));
+			if (idx >= arr->size)
+				throw out_of_range_error();
+			store_element(arr, idx, arguments->vector[1]);
+			return load_element(arr, idx);
+		}
+		catch (not_integer_error&)
+		{
+			throw invalid_arg_error();
+		}
+	};
+	native_fn_t typed_sum = [](variable this_var, s_array* arguments) {
+		s_typed_array* arr = this_typed_array(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		if (arr->element == element_type::float64)
+			return variable::number(reduce_f64<sum_op>(arr->f64(), arr->size, 0.0));
+
+		std::int64_t sum = 0;
+		for (std::size_t i = 0; i < arr->size; ++i)
+			sum += arr->i32()[i];
+		return variable::number(static_cast<double>(sum));
+	};
+	native_fn_t typed_min = [](variable this_var, s_array* arguments) {
+		s_typed_array* arr = this_typed_array(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		if (arr->size == 0)
+			throw out_of_range_error();
+		if (arr->element == element_type::float64)
+			return variable::number(reduce_f64<min_op>(arr->f64(), arr->size, arr->f64()[0]));
+		return variable::number(*std::min_element(arr->i32(), arr->i32() + arr->size));
+	};
+	native_fn_t typed_max = [](variable this_var, s_array* arguments) {
+		s_typed_array* arr = this_typed_array(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		if (arr->size == 0)
+			throw out_of_range_error();
+		if (arr->element == element_type::float64)
+			return variable::number(reduce_f64<max_op>(arr->f64(), arr->size, arr->f64()[0]));
+		return variable::number(*std::max_element(arr->i32(), arr->i32() + arr->size));
+	};
+	native_fn_t typed_dot = [](variable this_var, s_array* arguments) {
+		s_typed_array* arr = this_typed_array(this_var);
+
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		s_typed_array* other = operand_typed_array(arguments->vector[0], arr);
+		if (arr->element == element_type::float64)
+			return variable::number(dot_f64(arr->f64(), other->f64(), arr->size));
+
+		double sum = 0;
+		for (std::size_t i = 0; i < arr->size; ++i)
+			sum += static_cast<double>(arr->i32()[i]) * other->i32()[i];
+		return variable::number(sum);
+	};
+	native_fn_t typed_toarray = [](variable this_var, s_array* arguments) {
+		s_typed_array* arr = this_typed_array(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		s_array* ret = create_array(elements_kind::packed_int);
+		if (arr->element == element_type::float64)
+		{
+			ret->kind = elements_kind::packed_double;
+			ret->doubles.assign(arr->f64(), arr->f64() + arr->size);
+		}
+		else
+		{
+			ret->ints.assign(arr->i32(), arr->i32() + arr->size);
+		}
+		return variable::object(ret->obj());
+	};
+	native_fn_t float64_add = [](variable this_var, s_array* arguments) {
+		s_typed_array* arr = this_typed_array(this_var);
+
+		if (arguments->vector.size() != 1 || arr->element != element_type::float64)
+			throw invalid_arg_error();
+		s_typed_array* other = operand_typed_array(arguments->vector[0], arr);
+		elementwise_f64<sum_op>(arr->f64(), other->f64(), arr->size);
+		return this_var;
+	};
+	native_fn_t float64_mul = [](variable this_var, s_array* arguments) {
+		s_typed_array* arr = this_typed_array(this_var);
+
+		if (arguments->vector.size() != 1 || arr->element != element_type::float64)
+			throw invalid_arg_error();
+		s_typed_array* other = operand_typed_array(arguments->vector[0], arr);
+		elementwise_f64<mul_op>(arr->f64(), other->f64(), arr->size);
+		return this_var;
+	};
+	native_fn_t float64_scale = [](variable this_var, s_array* arguments) {
+		s_typed_array* arr = this_typed_array(this_var);
+
+		if (arguments->vector.size() != 1 || arr->element != element_type::float64)
+			throw invalid_arg_error();
+		if (arguments->vector[0].type != var_type::number)
+			throw invalid_arg_error();
+		scale_f64(arr->f64(), arguments->vector[0].v_number, arr->size);
+		return this_var;
+	};
+	native_fn_t float64_axpy = [](variable this_var, s_array* arguments) {
+		s_typed_array* arr = this_typed_array(this_var);
+
+		if (arguments->vector.size() != 2 || arr->element != element_type::float64)
+			throw invalid_arg_error();
+		if (arguments->vector[0].type != var_type::number)
+			throw invalid_arg_error();
+		s_typed_array* other = operand_typed_array(arguments->vector[1], arr);
+		axpy_f64(arr->f64(), arguments->vector[0].v_number, other->f64(), arr->size);
+		return this_var;
+	};
+	for (s_object* proto : { p_Float64Array, p_Int32Array })
+	{
+		proto->vars[create_string("size")] = create_native_function({ }, typed_size, false,
+			&array_length_epoch, intrinsic_kind::typed_size)->var();
+		proto->vars[create_string("get")] = create_native_function({ str_index }, typed_get, false,
+			nullptr, intrinsic_kind::typed_get)->var();
+		proto->vars[create_string("set")] = create_native_function({ str_index, str_val }, typed_set, false,
+			nullptr, intrinsic_kind::typed_set)->var();
+		proto->vars[create_string("sum")] = create_native_function({ }, typed_sum)->var();
+		proto->vars[create_string("min")] = create_native_function({ }, typed_min)->var();
+		proto->vars[create_string("max")] = create_native_function({ }, typed_max)->var();
+		proto->vars[create_string("dot")] = create_native_function({ str_other }, typed_dot)->var();
+		proto->vars[create_string("toArray")] = create_native_function({ }, typed_toarray)->var();
+	}
+	p_Float64Array->vars[create_string("add")] = create_native_function({ str_other }, float64_add)->var();
+	p_Float64Array->vars[create_string("mul")] = create_native_function({ str_other }, float64_mul)->var();
+	p_Float64Array->vars[create_string("scale")] = create_native_function({ str_factor }, float64_scale)->var();
+	p_Float64Array->vars[create_string("axpy")] = create_native_function({ str_factor, str_other }, float64_axpy)->var();
+
+	// parallel kernel
+	native_fn_t parallel_sum = [](variable this_var, s_array* arguments) {
+		numeric_source src = this_numeric_source(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		if (src.i32 != nullptr && this_var.v_object->type == object_type::typed_array)
+			return variable::number(static_cast<double>(parallel_int_sum(src.i32, src.size)));
+		if (src.size == 0)
+			return variable::number(0);
+
+		const reduce_op ops[1] = { reduce_op::sum };
+		double result[1];
+		parallel_reduce(src, ops, result);
+		return variable::number(result[0]);
+	};
+	native_fn_t parallel_minmax = [](variable this_var, s_array* arguments) {
+		numeric_source src = this_numeric_source(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		if (src.size == 0)
+			throw out_of_range_error();
+
+		const reduce_op ops[2] = { reduce_op::min, reduce_op::max };
+		double result[2];
+		parallel_reduce(src, ops, result);
+
+		s_array* ret = create_array(elements_kind::packed_int);
+		ret->push_back(variable::number(result[0]));
+		ret->push_back(variable::number(result[1]));
+		return variable::object(ret->obj());
+	};
+	native_fn_t parallel_reduce_fn = [](variable this_var, s_array* arguments) {
+		numeric_source src = this_numeric_source(this_var);
+
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		const reduce_op ops[1] = { to_reduce_op(arguments->vector[0]) };
+		if (src.size == 0)
+		{
+			if (ops[0] == reduce_op::sum)
+				return variable::number(0);
+			if (ops[0] == reduce_op::product)
+				return variable::number(1);
+			throw out_of_range_error();
+		}
+
+		double result[1];
+		parallel_reduce(src, ops, result);
+		return variable::number(result[0]);
+	};
+	native_fn_t parallel_map_fn = [](variable this_var, s_array* arguments) {
+		numeric_source src = this_numeric_source(this_var);
+
+		if (arguments->vector.size() != 2)
+			throw invalid_arg_error();
+		map_op op = to_map_op(arguments->vector[0]);
+		if (arguments->vector[1].type != var_type::number)
+			throw invalid_arg_error();
+
+		//   worker    thread Ҵմϴ.
+		if (this_var.v_object->type == object_type::typed_array)
+		{
+			s_typed_array* ret = create_typed_array(element_type::float64, src.size);
+			parallel_map(src, op, arguments->vector[1].v_number, ret->f64());
+			return variable::object(ret->obj());
+		}
+
+		s_array* ret = create_array(elements_kind::packed_double);
+		ret->doubles.resize(src.size);
+		parallel_map(src, op, arguments->vector[1].v_number, ret->doubles.data());
+		return variable::object(ret->obj());
+	};
+	// record array
+	native_fn_t records_size = [](variable this_var, s_array* arguments) {
+		s_record_array* records = this_record_array(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		return variable::number(records->size);
+	};
+	native_fn_t records_get = [](variable this_var, s_array* arguments) {
+		s_record_array* records = this_record_array(this_var);
+
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		std::size_t idx = to_array_position(arguments->vector[0], records->size);
+		if (idx == records->size)
+			throw out_of_range_error();
+		return variable::object(create_record(records, idx)->obj());
+	};
+	native_fn_t records_push = [](variable this_var, s_array* arguments) {
+		s_record_array* records = this_record_array(this_var);
+
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		variable rec = arguments->vector[0];
+		if (rec.type != var_type::object)
+			throw not_object_error();
+		if (rec.v_object == nullptr)
+			throw null_reference_error();
+
+		// column  ϳ  ٿٸ  ׸ ߳Ƿ  ̸ ϴ.
+		for (std::size_t i = 0; i < records->fields.size(); ++i)
+		{
+			s_array* column = records->columns[i];
+			while (column->size() < records->size)
+				column->push_back(variable::undefined());
+			while (column->size() > records->size)
+				column->pop_back();
+			column->push_back(get_member(rec.v_object, records->fields[i]));
+		}
+		++records->size;
+		return variable::number(records->size);
+	};
+	native_fn_t records_column = [](variable this_var, s_array* arguments) {
+		s_record_array* records = this_record_array(this_var);
+
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		variable name = arguments->vector[0];
+		if (name.type != var_type::object || name.v_object == nullptr || name.v_object->type != object_type::string)
+			throw not_string_error();
+		s_array* column = record_column(records, (s_string*)name.v_object);
+		if (column == nullptr)
+			throw invalid_arg_error();
+		return variable::object(column->obj());
+	};
+	native_fn_t records_fields = [](variable this_var, s_array* arguments) {
+		s_record_array* records = this_record_array(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		s_array* ret = create_array();
+		for (s_string* field : records->fields)
+			ret->push_back(variable::object(field->obj()));
+		return variable::object(ret->obj());
+	};
+	p_RecordArray->vars[create_string("size")] = create_native_function({ }, records_size)->var();
+	p_RecordArray->vars[create_string("get")] = create_native_function({ str_index }, records_get)->var();
+	p_RecordArray->vars[create_string("push")] = create_native_function({ str_record }, records_push)->var();
+	p_RecordArray->vars[create_string("column")] = create_native_function({ str_field }, records_column)->var();
+	p_RecordArray->vars[create_string("fields")] = create_native_function({ }, records_fields)->var();
+
+	// map
+	native_fn_t map_size_fn = [](variable this_var, s_array* arguments) {
+		s_map* map = this_map(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		return variable::number(map->size);
+	};
+	native_fn_t map_get_fn = [](variable this_var, s_array* arguments) {
+		s_map* map = this_map(this_var);
+
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		return map_get(map, arguments->vector[0]);
+	};
+	native_fn_t map_set_fn = [](variable this_var, s_array* arguments) {
+		s_map* map = this_map(this_var);
+
+		if (arguments->vector.size() != 2)
+			throw invalid_arg_error();
+		map_set(map, arguments->vector[0], arguments->vector[1]);
+		return this_var;
+	};
+	native_fn_t map_has_fn = [](variable this_var, s_array* arguments) {
+		s_map* map = this_map(this_var);
+
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		variable key = arguments->vector[0];
+		return variable::boolean(map_find(map, key, key_hash(key)) != map_npos);
+	};
+	native_fn_t map_delete_fn = [](variable this_var, s_array* arguments) {
+		s_map* map = this_map(this_var);
+
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		return variable::boolean(map_erase(map, arguments->vector[0]));
+	};
+	native_fn_t map_keys_fn = [](variable this_var, s_array* arguments) {
+		s_map* map = this_map(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		s_array* ret = create_array();
+		ret->reserve(map->size);
+		map_for_each(map, [ret](const map_slot& slot) { ret->push_back(slot.key); });
+		return variable::object(ret->obj());
+	};
+	p_Map->vars[create_string("size")] = create_native_function({ }, map_size_fn)->var();
+	p_Map->vars[create_string("get")] = create_native_function({ str_key }, map_get_fn)->var();
+	p_Map->vars[create_string("set")] = create_native_function({ str_key, str_value }, map_set_fn)->var();
+	p_Map->vars[create_string("has")] = create_native_function({ str_key }, map_has_fn)->var();
+	p_Map->vars[create_string("delete")] = create_native_function({ str_key }, map_delete_fn)->var();
+	p_Map->vars[create_string("keys")] = create_native_function({ }, map_keys_fn)->var();
+
+	// string
+	native_fn_t string_size = [](variable this_var, s_array* arguments) {
+		s_string* str = this_string(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		return variable::number(str->size);
+	};
+	native_fn_t string_substring = [](variable this_var, s_array* arguments) {
+		s_string* str = this_string(this_var);
+
+		if (arguments->vector.size() < 1 || arguments->vector.size() > 2)
+			throw invalid_arg_error();
+		std::size_t end = str->size;
+		if (arguments->vector.size() == 2)
+			end = to_array_position(arguments->vector[1], str->size);
+		std::size_t begin = to_array_position(arguments->vector[0], end);
+
+		return variable::object(create_slice(str, begin, end - begin)->obj());
+	};
+	native_fn_t string_indexof = [](variable this_var, s_array* arguments) {
+		s_string* str = this_string(this_var);
+
+		if (arguments->vector.size() < 1 || arguments->vector.size() > 2)
+			throw invalid_arg_error();
+		s_string* search = string_arg(arguments->vector[0]);
+		std::size_t from = 0;
+		if (arguments->vector.size() == 2)
+			from = to_array_position(arguments->vector[1], str->size);
+
+		std::size_t pos = find_bytes(str->ptr, str->size, search->ptr, search->size, from);
+		if (pos == string_npos)
+			return variable::number(-1);
+		return variable::number(static_cast<double>(pos));
+	};
+	native_fn_t string_startswith = [](variable this_var, s_array* arguments) {
+		s_string* str = this_string(this_var);
+
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		s_string* prefix = string_arg(arguments->vector[0]);
+
+		return variable::boolean(prefix->size <= str->size
+			&& std::memcmp(str->ptr, prefix->ptr, prefix->size) == 0);
+	};
+	native_fn_t string_split = [](variable this_var, s_array* arguments) {
+		s_string* str = this_string(this_var);
+
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		s_string* separator = string_arg(arguments->vector[0]);
+
+		s_array* ret = create_array();
+		if (separator->size == 0)
+		{
+			ret->reserve(str->size);
+			for (std::size_t i = 0; i < str->size; ++i)
+				ret->push_back(variable::object(create_slice(str, i, 1)->obj()));
+			return variable::object(ret->obj());
+		}
+
+		std::size_t begin = 0;
+		for (;;)
+		{
+			std::size_t pos = find_bytes(str->ptr, str->size, separator->ptr, separator->size, begin);
+			if (pos == string_npos)
+				break;
+			ret->push_back(variable::object(create_slice(str, begin, pos - begin)->obj()));
+			begin = pos + separator->size;
+		}
+		ret->push_back(variable::object(create_slice(str, begin, str->size - begin)->obj()));
+		return variable::object(ret->obj());
+	};
+	native_fn_t string_trim = [](variable this_var, s_array* arguments) {
+		s_string* str = this_string(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		std::size_t begin = 0;
+		std::size_t end = str->size;
+		while (begin < end && is_space(str->ptr[begin]))
+			++begin;
+		while (end > begin && is_space(str->ptr[end - 1]))
+			--end;
+
+		return variable::object(create_slice(str, begin, end - begin)->obj());
+	};
+	p_String->vars[create_string("size")] = create_native_function({ }, string_size)->var();
+	p_String->vars[create_string("substring")] = create_native_function({ str_begin, str_end }, string_substring)->var();
+	p_String->vars[create_string("indexOf")] = create_native_function({ str_search, str_from }, string_indexof)->var();
+	p_String->vars[create_string("startsWith")] = create_native_function({ str_prefix }, string_startswith)->var();
+	p_String->vars[create_string("split")] = create_native_function({ str_separator }, string_split)->var();
+	p_String->vars[create_string("trim")] = create_native_function({ }, string_trim)->var();
+
+	// string builder
+	native_fn_t builder_append_fn = [](variable this_var, s_array* arguments) {
+		s_string_builder* builder = this_string_builder(this_var);
+
+		//    ڰ   ڵ ̱  ǵϴ.
+		std::size_t old_size = builder->buffer.size();
+		try
+		{
+			for (variable v : arguments->vector)
+				builder_append(builder, v);
+		}
+		catch (...)
+		{
+			builder->buffer.resize(old_size);
+			throw;
+		}
+		if (!arguments->vector.empty())
+			builder->flat = nullptr;
+		return this_var;
+	};
+	native_fn_t builder_size_fn = [](variable this_var, s_array* arguments) {
+		s_string_builder* builder = this_string_builder(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		return variable::number(builder->buffer.size());
+	};
+	native_fn_t builder_tostring_fn = [](variable this_var, s_array* arguments) {
+		s_string_builder* builder = this_string_builder(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		return variable::object(builder_flatten(builder)->obj());
+	};
+	native_fn_t builder_clear_fn = [](variable this_var, s_array* arguments) {
+		s_string_builder* builder = this_string_builder(this_var);
+
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		builder->buffer.clear();
+		builder->flat = nullptr;
+		return this_var;
+	};
+	p_StringBuilder->vars[create_string("append")] = create_native_function({ }, builder_append_fn, true)->var();
+	p_StringBuilder->vars[create_string("size")] = create_native_function({ }, builder_size_fn)->var();
+	p_StringBuilder->vars[create_string("toString")] = create_native_function({ }, builder_tostring_fn)->var();
+	p_StringBuilder->vars[create_string("clear")] = create_native_function({ }, builder_clear_fn)->var();
+
+	for (s_object* proto : { p_Array, p_Float64Array, p_Int32Array })
+	{
+		proto->vars[create_string("parallelSum")] = create_native_function({ }, parallel_sum)->var();
+		proto->vars[create_string("parallelMinMax")] = create_native_function({ }, parallel_minmax)->var();
+		proto->vars[create_string("parallelReduce")] = create_native_function({ str_op }, parallel_reduce_fn)->var();
+		proto->vars[create_string("parallelMap")] = create_native_function({ str_op, str_operand }, parallel_map_fn)->var();
+	}
+
+	// register constructors into global object
+	global_object = create_object();
+	global_object->vars[str_object] = variable::object(f_Object);
+	global_object->vars[str_function] = variable::object(f_Function);
+	global_object->vars[str_string] = variable::object(f_String);
+	global_object->vars[str_array] = variable::object(f_Array);
+	global_object->vars[str_float64array] = variable::object(f_Float64Array);
+	global_object->vars[str_int32array] = variable::object(f_Int32Array);
+	global_object->vars[str_recordarray] = variable::object(f_RecordArray);
+	global_object->vars[str_map] = variable::object(f_Map);
+	global_object->vars[str_stringbuilder] = variable::object(f_StringBuilder);
+
+	// predefined variables
+	this_var = variable::object(global_object);
+	prev_var = variable::undefined();
+
+	// repl
+	replconfig_object = create_object();
+	replconfig_object->vars[str_dumpexpr] = variable::boolean(false);
+	replconfig_object->vars[str_profilealloc] = variable::boolean(false);
+	replconfig_object->vars[str_tierlog] = variable::boolean(false);
+	replconfig_object->vars[str_warmthreshold] = variable::number(warm_threshold);
+	replconfig_object->vars[str_jitthreshold] = variable::number(jit_threshold);
+	global_object->vars[str_replconfig] = variable::object(replconfig_object);
+
+	// console
+	native_fn_t console_dump = [](variable this_var, s_array* arguments) {
+		for (variable var : arguments->vector)
+		{
+			print_var(std::cout, var);
+			std::cout << std::endl;
+		}
+		return variable::undefined();
+	};
+	native_fn_t console_readline = [](variable this_var, s_array* arguments) {
+		std::string line;
+		getline(std::cin, line);
+		return create_string(line)->var();
+	};
+	native_fn_t console_heapsnapshot = [](variable this_var, s_array* arguments) {
+		if (arguments->vector.empty())
+		{
+			heap_snapshot(std::cout, nullptr);
+			return variable::undefined();
+		}
+
+		if (arguments->vector[0].type != var_type::object)
+			throw invalid_arg_error();
+		if (arguments->vector[0].v_object == nullptr)
+			throw null_reference_error();
+		if (arguments->vector[0].v_object->type != object_type::string)
+			throw invalid_arg_error();
+		s_string* path = (s_string*)arguments->vector[0].v_object;
+
+		std::ofstream file(to_std_string(path));
+		if (!file)
+			throw file_open_error();
+
+		heap_snapshot(std::cout, &file);
+		return variable::undefined();
+	};
+	native_fn_t console_typefeedback = [](variable this_var, s_array* arguments) {
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		if (arguments->vector[0].type != var_type::object)
+			throw invalid_arg_error();
+		if (arguments->vector[0].v_object == nullptr)
+			throw null_reference_error();
+		if (arguments->vector[0].v_object->type != object_type::function)
+			throw not_function_error();
+		s_function* fn = (s_function*)arguments->vector[0].v_object;
+		if (fn->templ->is_native)
+			throw invalid_arg_error();
+
+		dump_type_feedback(std::cout, *fn->templ->expr);
+		return variable::undefined();
+	};
+	native_fn_t console_dynamicsites = [](variable this_var, s_array* arguments) {
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		if (arguments->vector[0].type != var_type::object)
+			throw invalid_arg_error();
+		if (arguments->vector[0].v_object == nullptr)
+			throw null_reference_error();
+		if (arguments->vector[0].v_object->type != object_type::function)
+			throw not_function_error();
+		s_function* fn = (s_function*)arguments->vector[0].v_object;
+		if (fn->templ->is_native)
+			throw invalid_arg_error();
+
+		//  type ߷  Լ  tier 1 øϴ.
+		promote_function(fn, 1);
+		dump_static_types(std::cout, *fn->templ->expr);
+		return variable::undefined();
+	};
+	console_object = create_object();
+	console_object->vars[create_string("dump")] = create_native_function({ }, console_dump, true)->var();
+	console_object->vars[create_string("readLine")] = create_native_function({ }, console_readline)->var();
+	console_object->vars[create_string("heapSnapshot")] = create_native_function({ str_path }, console_heapsnapshot)->var();
+	console_object->vars[create_string("typeFeedback")] = create_native_function({ str_fn }, console_typefeedback)->var();
+	console_object->vars[create_string("dynamicSites")] = create_native_function({ str_fn }, console_dynamicsites)->var();
+	global_object->vars[create_string("console")] = variable::object(console_object);
+
+	// global functions
+	native_fn_t fn_parseFloat = [](variable this_var, s_array* arguments) {
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		if (arguments->vector[0].type != var_type::object)
+			throw invalid_arg_error();
+		if (arguments->vector[0].v_object == nullptr)
+			throw null_reference_error();
+		if (arguments->vector[0].v_object->type != object_type::string)
+			throw invalid_arg_error();
+		s_string* str = (s_string*)arguments->vector[0].v_object;
+
+		const std::string text = to_std_string(str);
+		char* endptr;
+		double num = std::strtod(text.c_str(), &endptr);
+		if (*endptr != '\0')
+			throw invalid_arg_error();
+
+		return variable::number(num);
+	};
+	global_object->vars[create_string("parseFloat")] = create_native_function({ str_str }, fn_parseFloat)->var();
+
+	native_fn_t fn_float64Array = [](variable this_var, s_array* arguments) {
+		return typed_array_from(element_type::float64, arguments);
+	};
+	global_object->vars[create_string("float64Array")] = create_native_function({ str_source }, fn_float64Array)->var();
+
+	native_fn_t fn_int32Array = [](variable this_var, s_array* arguments) {
+		return typed_array_from(element_type::int32, arguments);
+	};
+	global_object->vars[create_string("int32Array")] = create_native_function({ str_source }, fn_int32Array)->var();
+
+	native_fn_t fn_recordArray = [](variable this_var, s_array* arguments) {
+		if (arguments->vector.size() < 2)
+			throw invalid_arg_error();
+		variable ctor = arguments->vector[0];
+		if (ctor.type != var_type::object || ctor.v_object == nullptr || ctor.v_object->type != object_type::function)
+			throw not_function_error();
+
+		auto pit = find_member(ctor.v_object, str_prototype);
+		if (!pit || (*pit)->second.type != var_type::object || (*pit)->second.v_object == nullptr)
+			throw invalid_arg_error();
+
+		gc_vector<s_string*> fields;
+		for (std::size_t i = 1; i < arguments->vector.size(); ++i)
+		{
+			variable name = arguments->vector[i];
+			if (name.type != var_type::object || name.v_object == nullptr || name.v_object->type != object_type::string)
+				throw not_string_error();
+			fields.push_back(own_string((s_string*)name.v_object));
+		}
+		return variable::object(create_record_array((*pit)->second.v_object, fields)->obj());
+	};
+	global_object->vars[create_string("recordArray")] = create_native_function({ str_ctor }, fn_recordArray, true)->var();
+
+	native_fn_t fn_loadModule = [](variable this_var, s_array* arguments) {
+		if (arguments->vector.size() != 1)
+			throw invalid_arg_error();
+		if (arguments->vector[0].type != var_type::object)
+			throw invalid_arg_error();
+		if (arguments->vector[0].v_object == nullptr)
+			throw null_reference_error();
+		if (arguments->vector[0].v_object->type != object_type::string)
+			throw invalid_arg_error();
+		s_string* name = (s_string*)arguments->vector[0].v_object;
+
+		return aot_load_module(to_std_string(name));
+	};
+	global_object->vars[create_string("loadModule")] = create_native_function({ str_name }, fn_loadModule)->var();
+
+	// script atom    s_string Ű  ̸  internմϴ.
+	for (s_object* obj : { global_object, p_Object, p_Function, p_String, p_Array, p_Float64Array, p_Int32Array,
+		p_RecordArray, p_Map, p_StringBuilder, replconfig_object, console_object })
+	{
+		for (const auto& pr : obj->vars)
+			intern_string(pr.first);
+	}
+	intern_string(str_prototype);
+}
+
+bool read_expr(std::istream& strm, expression& ret, const std::weak_ptr<expression>& root)
+{
+	auto getc = [&strm]
+	{
+		if (strm.eof())
+			return -1;
+		int ch = io::get(strm);
+		return ch;
+	};
+
+	int ch;
+
+	do
+	{
+		ch = getc();
+		if (ch == '\n' || ch == -1)
+			return false;
+	}
+	while (std::isspace(ch));
+
+	std::string value;
+
+	if (ch == '"')
+	{
+		ret.type = expr_type::string;
+
+		while (true)
+		{
+			ch = getc();
+			if (ch == -1)
+				return false;
+
+			if (ch == '"')
+			{
+				break;
+			}
+			else if (ch == '\n')
+			{
+				throw unexpected_newline_error();
+			}
+			else if (ch == '\\')
+			{
+				ch = getc();
+				if (ch == -1)
+					throw unexpected_eof_error();
+
+				static char tbl[256] = { 0 };
+				tbl['t'] = '\t';
+				tbl['n'] = '\n';
+				tbl['\\'] = '\\';
+
+				if (tbl[ch] != 0)
+					value.push_back(tbl[ch]);
+				else
+					throw invalid_escape_error();
+			}
+			else if (std::isspace(ch))
+			{
+				value.push_back(' ');
+			}
+			else
+			{
+				value.push_back(ch);
+			}
+		}
+	}
+	else if (ch == '(')
+	{
+		ret.type = expr_type::list;
+
+		while (true)
+		{
+			ch = getc();
+			if (ch == -1)
+				throw unexpected_eof_error();
+
+			if (std::isspace(ch))
+			{
+				continue;
+			}
+			else if (ch == ')')
+			{
+				break;
+			}
+			else
+			{
+				strm.unget();
+
+				ret.list.emplace_back();
+				read_expr(strm, ret.list.back(), root);
+			}
+		}
+	}
+	else
+	{
+		while (true)
+		{
+			if (ch == '(' || ch == ')')
+			{
+				strm.unget();
+				break;
+			}
+			else if (std::isspace(ch))
+			{
+				strm.unget();
+				break;
+			}
+			else if (std::isgraph(ch))
+			{
+				value.push_back(ch);
+			}
+			else
+			{
+				if (!value.empty() && std::isdigit(value[0]))
+					throw invalid_number_error();
+				else
+					throw invalid_atom_error();
+			}
+
+			ch = getc();
+			if (ch == -1)
+				throw unexpected_eof_error();
+		}
+
+		if (!std::isdigit(value[0]))
+		{
+			ret.type = expr_type::atom;
+		}
+		else
+		{
+			char* endptr;
+			double num = std::strtod(value.c_str(), &endptr);
+			if (*endptr != '\0')
+				throw invalid_number_error();
+
+			ret.type = expr_type::number;
+			ret.number = num;
+		}
+	}
+
+	if (ret.type == expr_type::atom)
+	{
+		ret.value = intern_string(create_string(value));
+	}
+	else if (ret.type == expr_type::string)
+	{
+		ret.value = create_string(value);
+	}
+	ret.root = root;
+
+	return true;
+}
+
+struct eval_context
+{
+};
+
+// atom keywords
+variable eval_expr_keyword_global(eval_context& context);
+variable eval_expr_keyword_this(eval_context& context);
+variable eval_expr_keyword_undefined(eval_context& context);
+variable eval_expr_keyword_null(eval_context& context);
+variable eval_expr_keyword_true(eval_context& context);
+variable eval_expr_keyword_false(eval_context& context);
+variable eval_expr_keyword_prev(eval_context& context);
+variable eval_expr_keyword_arguments(eval_context& context);
+variable eval_expr_keyword_dotdotdot_(eval_context& context);
+
+// function call
+variable eval_expr_call(const expression& expr, eval_context& context);
+// receiver expr.list[0] ̹  Լ ȣԴϴ.
+variable eval_call_with_receiver(const expression& expr, variable var);
+
+// list keywords
+variable eval_expr_keyword_func(const expression& expr, eval_context& context);
+variable eval_expr_keyword_new(const expression& expr, eval_context& context);
+variable eval_expr_keyword_array(const expression& expr, eval_context& context);
+variable eval_expr_keyword_getf(const expression& expr, eval_context& context);
+variable eval_expr_keyword_setf(const expression& expr, eval_context& context);
+variable eval_expr_keyword_getl(const expression& expr, eval_context& context);
+variable eval_expr_keyword_setl(const expression& expr, eval_context& context);
+variable eval_expr_keyword_geti(const expression& expr, eval_context& context);
+variable eval_expr_keyword_seti(const expression& expr, eval_context& context);
+variable eval_expr_keyword_do(const expression& expr, eval_context& context);
+variable eval_expr_keyword_if(const expression& expr, eval_context& context);
+variable eval_expr_keyword_while(const expression& expr, eval_context& context);
+variable eval_expr_keyword_plus_(const expression& expr, eval_context& context);
+variable eval_expr_keyword_minus_(const expression& expr, eval_context& context);
+variable eval_expr_keyword_multiply_(const expression& expr, eval_context& context);
+variable eval_expr_keyword_division_(const expression& expr, eval_context& context);
+variable eval_expr_keyword_modulo_(const expression& expr, eval_context& context);
+variable eval_expr_keyword_idiv(const expression& expr, eval_context& context);
+variable eval_expr_keyword_imod(const expression& expr, eval_context& context);
+variable eval_expr_keyword_bitand_(const expression& expr, eval_context& context);
+variable eval_expr_keyword_bitor_(const expression& expr, eval_context& context);
+variable eval_expr_keyword_bitxor_(const expression& expr, eval_context& context);
+variable eval_expr_keyword_and(const expression& expr, eval_context& context);
+variable eval_expr_keyword_or(const expression& expr, eval_context& context);
+variable eval_expr_keyword_not(const expression& expr, eval_context& context);
+variable eval_expr_keyword_eq_(const expression& expr, eval_context& context);
+variable eval_expr_keyword_ne_(const expression& expr, eval_context& context);
+variable eval_expr_keyword_lt_(const expression& expr, eval_context& context);
+variable eval_expr_keyword_lte_(const expression& expr, eval_context& context);
+variable eval_expr_keyword_gt_(const expression& expr, eval_context& context);
+variable eval_expr_keyword_gte_(const expression& expr, eval_context& context);
+
+/**
+ * type feedback quickening
+ * +, -, *, /, %  node operand type expression::feedback մϴ.
+ * quicken_threshold ϴ  number ôٸ node handler number  handler ٲߴϴ.
+ * number  handler literal number  ڽ node  ˻  ,  operand   ˻մϴ.
+ * ˻翡 ϸ deoptimize() node Ϲ handler ǵ, Ϲ handler   ܸ ϴ.
+ * feedback  ٸ type   node ٽ Ưȭ ʽϴ.
+ **/
+const std::uint16_t quicken_threshold = 8;
+
+inline std::uint8_t feedback_bit(var_type type)
+{
+	return static_cast<std::uint8_t>(1 << static_cast<int>(type));
+}
+
+inline void record_feedback(const expression& expr, variable v)
+{
+	expr.feedback |= feedback_bit(v.type);
+}
+
+inline void quicken(const expression& expr, list_keyword_fn handler, number_fn number_handler = nullptr)
+{
+	if (expr.samples < quicken_threshold)
+	{
+		++expr.samples;
+	}
+	else if (expr.feedback == feedback_bit(var_type::number) && expr.handler != handler)
+	{
+		expr.handler = handler;
+		expr.number_handler = number_handler;
+	}
+}
+
+void deoptimize(const expression& expr, variable seen);
+
+variable quick_number_value(const expression& expr, eval_context& context);
+double quick_plus_number(const expression& expr);
+double quick_minus_number(const expression& expr);
+double quick_multiply_number(const expression& expr);
+double quick_division_number(const expression& expr);
+double quick_modulo_number(const expression& expr);
+variable quick_lt_number(const expression& expr, eval_context& context);
+variable quick_lte_number(const expression& expr, eval_context& context);
+variable quick_gt_number(const expression& expr, eval_context& context);
+variable quick_gte_number(const expression& expr, eval_context& context);
+variable quick_eq_number(const expression& expr, eval_context& context);
+variable quick_ne_number(const expression& expr, eval_context& context);
+
+/**
+ * static type inference
+ * func    鼭   number, boolean, dynamic  ϳ մϴ.
+ * number literal,   , 񱳿 and/or/not , ׸ ׷  setl  type մϴ.
+ * if  branch  ġ, while  type  ٲ    ݺؼ Ƚϴ.
+ *  dynamic scope ȣ Լ setl ٲ  Ƿ, Լ ȣ new    dynamic ǵϴ.
+ * global  global object ̱⵵ ϹǷ setf seti   Դϴ.
+ * operand  number    񱳿 number  handler ̸ ̰,
+ * boolean   to_conditional() ġ ʽϴ.
+ **/
+void infer_types(const expression& body);
+
+//  expression մϴ. boolean   ˻ ʽϴ.
+inline bool eval_condition(const expression& cond)
+{
+	if (cond.inferred == static_type::boolean)
+		return eval_expr(cond).v_boolean;
+	return to_conditional(eval_expr(cond));
+}
+
+/**
+ *  Լ inlining
+ *  Լ inline_threshold ޾ ȣ call site  Լ  纻  մϴ.
+ * native ƴϰ,  ڿ arguments  ,  inline_node_limit  nodḛ,
+ *  Լ ȣ, new, func, setl  Լ inlineմϴ.
+ * ̷  ٸ Լ θ ʾ    stackframe 鿩ٺ Ƿ,
+ * frame arguments 迭  ʾƵ  ϴ.
+ * 纻 parameter  call site C++ stack   ڸ ٷ нϴ.
+ * call site Ź ó Լ ãƼ inline Ͱ  function_template Ȯմϴ.
+ * setl Լ ٽ ߴٸ 纻  Ϲ ȣ ư,
+ * inline_deopt_limit ǵ call site  ̻ inline ʽϴ.
+ **/
+const std::uint32_t inline_threshold = 16;
+const std::size_t inline_node_limit = 32;
+const std::size_t inline_max_parameters = 8;
+const std::uint16_t inline_deopt_limit = 4;
+
+struct call_site_cache
+{
+	//  ȣ ԼԴϴ. target_root guard ϴ  template  ʰ ƵӴϴ.
+	const function_template* target { nullptr };
+	std::shared_ptr<expression> target_root;
+	std::uint32_t hits { 0 };
+
+	// parameter   slot ٲ target  纻Դϴ. inlineϱ   ֽϴ.
+	std::shared_ptr<expression> body;
+	std::uint16_t deopts { 0 };
+	bool disabled { false };
+
+	// Ʒ while  method ȣ(loop site) ϴ.
+	bool loop_site { false };
+	s_function* method { nullptr };
+	std::uint64_t method_shape { 0 };
+	bool has_result { false };
+	std::uint64_t result_epoch { 0 };
+
+	// receiver   Դϴ. GC  object ϰ ּҸ ٽ  ʵ traceable ޸𸮿 Ӵϴ.
+	gc_vector<variable> pinned { variable::undefined(), variable::undefined() };
+
+	// intrinsic site method  Ȯ  shape_epoch Ϲ ȣ ǵ ȽԴϴ.
+	std::uint64_t intrinsic_shape { 0 };
+	std::uint16_t intrinsic_deopts { 0 };
+};
+
+/**
+ * Array intrinsic
+ * (arr size), (arr get i), (arr set i v) p_Array  native θ call site handler
+ * ȣ  迭  а  handler ٲߴϴ. arguments 迭 frame  ʰ,
+ *  ˻ ܴ native ϴ.
+ * receiver ڱ   array̰ shape_epoch ״ζ method ٽ ã ʽϴ.
+ * shape_epoch ٲٸ method   ã   native Ȯմϴ.
+ * guard ϸ Ϲ ȣ ư, intrinsic_deopt_limit ǵ site  ̻ ٲ ʽϴ.
+ **/
+const std::uint16_t intrinsic_deopt_limit = 4;
+
+void quicken_intrinsic(const expression& expr, s_function* fn, variable receiver);
+
+/**
+ * loop Һ lookup hoisting
+ * optimize_expr() while ǰ  ִ method ȣ node loop site ǥմϴ.
+ * loop site receiver object ã method  ΰ,  receiver prototype chain ٽ ã ʽϴ.
+ *  method   ȣ  native Լ(result_epoch ִ Լ)   ΰ ٽ ȣ ʽϴ.
+ * setf, setió object  ٲٴ  shape_epoch ø,  native  ٲٴ 
+ *  Լ result_epoch øϴ. loop site epoch   ϴ     Ȯմϴ.
+ **/
+void hoist_loop_invariants(expression& expr);
+
+void profile_call_site(const expression& expr, s_function* fn);
+void deoptimize_inline(call_site_cache& cache);
+variable eval_inlined_call(const expression& expr, const call_site_cache& cache, s_function* fn, variable new_this);
+
+using atom_keyword_map_t = std::unordered_map<
+	std::string, std::function<variable(eval_context& context)>>;
+using list_keyword_map_t = std::unordered_map<std::string, list_keyword_fn>;
+atom_keyword_map_t atom_keyword_map = {
+	{ "global",		eval_expr_keyword_global },
+	{ "this",		eval_expr_keyword_this },
+	{ "undefined",	eval_expr_keyword_undefined },
+	{ "null",		eval_expr_keyword_null },
+	{ "true",		eval_expr_keyword_true },
+	{ "false",		eval_expr_keyword_false },
+	{ "prev",		eval_expr_keyword_prev },
+	{ "arguments",	eval_expr_keyword_arguments },
+	{ "...",		eval_expr_keyword_dotdotdot_ },
+};
+list_keyword_map_t list_keyword_map = {
+	{ "func",		eval_expr_keyword_func },
+	{ "new",		eval_expr_keyword_new },
+	{ "array",		eval_expr_keyword_array },
+	{ "getf",		eval_expr_keyword_getf },
+	{ "setf",		eval_expr_keyword_setf },
+	{ "getl",		eval_expr_keyword_getl },
+	{ "setl",		eval_expr_keyword_setl },
+	{ "geti",		eval_expr_keyword_geti },
+	{ "seti",		eval_expr_keyword_seti },
+	{ "do",			eval_expr_keyword_do },
+	{ "if",			eval_expr_keyword_if },
+	{ "while",		eval_expr_keyword_while },
+	{ "+",			eval_expr_keyword_plus_ },
+	{ "-",			eval_expr_keyword_minus_ },
+	{ "*",			eval_expr_keyword_multiply_ },
+	{ "/",			eval_expr_keyword_division_ },
+	{ "%",			eval_expr_keyword_modulo_ },
+	{ "idiv",		eval_expr_keyword_idiv },
+	{ "imod",		eval_expr_keyword_imod },
+	{ "&",			eval_expr_keyword_bitand_ },
+	{ "|",			eval_expr_keyword_bitor_ },
+	{ "^",			eval_expr_keyword_bitxor_ },
+	{ "and",		eval_expr_keyword_and },
+	{ "or",			eval_expr_keyword_or },
+	{ "not",		eval_expr_keyword_not },
+	{ "=",			eval_expr_keyword_eq_ },
+	{ "/=",			eval_expr_keyword_ne_ },
+	{ "<",			eval_expr_keyword_lt_ },
+	{ "<=",			eval_expr_keyword_lte_ },
+	{ ">",			eval_expr_keyword_gt_ },
+	{ ">=",			eval_expr_keyword_gte_ },
+};
+
+bool is_keyword(const std::string &str)
+{
+	return (atom_keyword_map.find(str) != atom_keyword_map.end()
+		|| list_keyword_map.find(str) != list_keyword_map.end());
+}
+
+variable eval_expr(const expression& expr)
+{
+	eval_context context;
+
+	if (expr.type == expr_type::string)
+	{
+		return variable::object(expr.value->obj());
+	}
+	else if (expr.type == expr_type::number)
+	{
 		return variable::number(expr.number);
 	}
-	else if (expr.type == expr_type::atom)
+	else if (expr.type == expr_type::atom)
+	{
+		auto it = atom_keyword_map.find(expr.value->ptr);
+		if (it != atom_keyword_map.end())
+		{
+			return it->second(context);
+		}
+		else
+		{
+			// getl
+			return load_local(expr);
+		}
+	}
+	else
+	{
+		assert(expr.type == expr_type::list);
+
+		if (expr.list.empty())
+			return variable::undefined();
+
+		alloc_site_guard site_guard(expr);
+
+		if (expr.handler != nullptr)
+			return expr.handler(expr, context);
+
+		auto& front = expr.list.front();
+
+		if (front.type == expr_type::atom)
+		{
+			auto it = list_keyword_map.find(front.value->ptr);
+			if (it != list_keyword_map.end())
+			{
+				expr.handler = it->second;
+				return it->second(expr, context);
+			}
+		}
+
+		expr.handler = eval_expr_call;
+		return eval_expr_call(expr, context);
+	}
+}
+
+variable eval_expr_call(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() <= 1)
+		throw invalid_func_call();
+
+	return eval_call_with_receiver(expr, eval_expr(expr.list[0]));
+}
+
+variable eval_call_with_receiver(const expression& expr, variable var)
+{
+	s_function* f_fn = nullptr;
+
+	call_site_cache* loop_cache = expr.call_cache.get();
+	if (loop_cache != nullptr && !loop_cache->loop_site)
+		loop_cache = nullptr;
+
+	if (loop_cache != nullptr && var.type == var_type::object && var.v_object != nullptr
+		&& loop_cache->pinned[0] == var && loop_cache->method_shape == shape_epoch)
+	{
+		f_fn = loop_cache->method;
+
+		if (loop_cache->has_result && *f_fn->templ->result_epoch == loop_cache->result_epoch)
+		{
+			// call_function()    this ǵϴ.
+			if (!stackframe.empty())
+				this_var = stackframe.front().this_var;
+			else
+				this_var = variable::object(global_object);
+			return loop_cache->pinned[1];
+		}
+	}
+	else if (expr.list[1].type == expr_type::atom)
+	{
+		// try member function call
+		f_fn = find_method(var, expr.list[1].value);
+
+		if (loop_cache != nullptr && f_fn != nullptr && !is_record_field(var, expr.list[1].value))
+		{
+			loop_cache->pinned[0] = var;
+			loop_cache->method = f_fn;
+			loop_cache->method_shape = shape_epoch;
+			loop_cache->has_result = false;
+		}
+	}
+
+	if (f_fn == nullptr)
+	{
+		variable var2 = eval_expr(expr.list[1]);
+		if (var2.type == var_type::object && var2.v_object->type == object_type::function)
+		{
+			f_fn = (s_function*)var2.v_object;
+		}
+	}
+
+	if (f_fn == nullptr)
+	{
+		throw list_evaluate_error();
+	}
+
+	if (!f_fn->templ->is_native)
+	{
+		call_site_cache* cache = expr.call_cache.get();
+		if (cache != nullptr && cache->body)
+		{
+			if (cache->target == f_fn->templ)
+			{
+				if (expr.list.size() - 2 <= cache->target->parameters.size())
+					return eval_inlined_call(expr, *cache, f_fn, var);
+			}
+			else
+			{
+				deoptimize_inline(*cache);
+			}
+		}
+
+		if (cache == nullptr || !cache->body)
+			profile_call_site(expr, f_fn);
+	}
+	else if (f_fn->templ->intrinsic != intrinsic_kind::none && expr.handler == eval_expr_call)
+	{
+		quicken_intrinsic(expr, f_fn, var);
+	}
+
+	s_array local_arguments;
+	s_array* arguments = prepare_arguments(f_fn, local_arguments);
+
+	for (auto it = expr.list.begin() + 2; it != expr.list.end(); ++it)
+	{
+		arguments->vector.push_back(eval_expr(*it));
+	}
+
+	if (loop_cache != nullptr && f_fn == loop_cache->method && loop_cache->pinned[0] == var
+		&& loop_cache->method_shape == shape_epoch && f_fn->templ->result_epoch != nullptr && expr.list.size() == 2)
+	{
+		std::uint64_t epoch = *f_fn->templ->result_epoch;
+		variable ret = call_function(f_fn, var, arguments);
+
+		loop_cache->pinned[1] = ret;
+		loop_cache->result_epoch = epoch;
+		loop_cache->has_result = true;
+		return ret;
+	}
+
+	return call_function(f_fn, var, arguments);
+}
+
+bool to_conditional(variable var)
+{
+	if ((var.type == var_type::boolean && var.v_boolean)
+		|| (var.type == var_type::object && var.v_object != nullptr))
+	{
+		return true;
+	}
+	else if ((var.type == var_type::boolean && !var.v_boolean)
+		|| (var.type == var_type::object && var.v_object == nullptr)
+		|| var.type == var_type::undefined)
+	{
+		return false;
+	}
+	else
+	{
+		throw invalid_conditional();
+	}
+}
+
+std::int64_t to_integer(double n)
+{
+	double intpart;
+	if (std::modf(n, &intpart) != 0.0)
+		throw not_integer_error();
+	if (intpart > INT64_MAX)
+		throw not_integer_error();
+	return static_cast<std::int64_t>(intpart);
+}
+
+boost::optional<object_map::iterator> find_member(s_object* obj, s_string* name)
+{
+	do
+	{
+		auto it = obj->vars.find(name);
+		if (it != obj->vars.end())
+			return it;
+
+		obj = obj->proto;
+	} while (obj != nullptr);
+
+	return boost::optional<object_map::iterator>();
+}
+
+boost::optional<object_map::iterator> find_local(s_string* name)
+{
+	auto pit = find_frame_local(name);
+	if (pit)
+		return pit;
+
+	return find_member(global_object, name);
+}
+
+boost::optional<object_map::iterator> find_frame_local(s_string* name)
+{
+	if (!stackframe.empty())
+	{
+		for (auto sit = stackframe.rbegin(); sit != stackframe.rend(); ++sit)
+		{
+			for (auto bit = sit->blocks.rbegin(); bit != sit->blocks.rend(); ++bit)
+			{
+				auto it = bit->find(name);
+				if (it != bit->end())
+				{
+					return it;
+				}
+			}
+		}
+	}
+
+	return boost::optional<object_map::iterator>();
+}
+
+variable load_local(const expression& atom)
+{
+	if (atom.global_cell != nullptr && atom.global_cell_epoch == global_cell_epoch)
+		return atom.global_cell->second;
+
+	if (frame_names.find(atom.value) != frame_names.end())
+	{
+		auto pit = find_local(atom.value);
+		return pit ? (*pit)->second : variable::undefined();
+	}
+
+	auto pit = find_member(global_object, atom.value);
+	if (!pit)
+		return variable::undefined();
+
+	atom.global_cell = &**pit;
+	atom.global_cell_epoch = global_cell_epoch;
+	return (*pit)->second;
+}
+
+inline bool is_function_value(variable v)
+{
+	return v.type == var_type::object && v.v_object != nullptr && v.v_object->type == object_type::function;
+}
+
+s_array* record_column(s_record_array* records, s_string* name)
+{
+	for (std::size_t i = 0; i < records->fields.size(); ++i)
+	{
+		if (records->fields[i] == name || pstr_equal()(records->fields[i], name))
+			return records->columns[i];
+	}
+	return nullptr;
+}
+
+variable get_member(s_object* obj, s_string* name)
+{
+	if (obj->type == object_type::record)
+	{
+		s_record* rec = (s_record*)obj;
+		s_array* column = record_column(rec->owner, name);
+		if (column != nullptr)
+			return rec->index < column->size() ? column->get(rec->index) : variable::undefined();
+	}
+
+	auto pit = find_member(obj, name);
+	return pit ? (*pit)->second : variable::undefined();
+}
+
+void set_member(s_object* obj, s_string* name, variable val)
+{
+	if (obj->type == object_type::record)
+	{
+		s_record* rec = (s_record*)obj;
+		s_array* column = record_column(rec->owner, name);
+		if (column != nullptr)
+		{
+			if (rec->index >= column->size())
+				throw out_of_range_error();
+			column->set(rec->index, val);
+			return;
+		}
+		if (!find_member(obj, name))
+			throw invalid_arg_error();
+	}
+
+	auto pit = find_member(obj, name);
+	if (pit)
+	{
+		// Լ ƴ  ٲٴ  find_method()  ٲ ʽϴ.
+		if (is_function_value((*pit)->second) || is_function_value(val))
+			++shape_epoch;
+		(*pit)->second = val;
+	}
+	else
+	{
+		++shape_epoch;
+		if (obj == global_object)
+			++global_cell_epoch;
+		// ̸ table ٸ ״ key ϴ. slice parent  ʵ մϴ.
+		obj->vars.insert({ own_string(find_interned(name)), val });
+	}
+}
+
+variable call_function(s_function* fn, variable new_this, s_array* arguments)
+{
+	const function_template* templ = fn->templ;
+	if (templ->parameters.size() < arguments->vector.size() && !templ->is_variadic)
+		throw invalid_arg_error();
+
+	frame_entry frame;
+	frame.function = fn;
+	frame.arguments = arguments;
+
+	object_map locals;
+	for (std::size_t i = 0; i < templ->parameters.size(); ++i)
+	{
+		variable val;
+		if (i < frame.arguments->vector.size())
+			val = frame.arguments->vector[i];
+		else
+			val = variable::undefined();
+
+		locals.insert({ templ->parameters[i], val });
+	}
+	frame.blocks.push_back(std::move(locals));
+	frame.this_var = new_this;
+
+	stackframe.push_back(frame);
+	this_var = new_this;
+
+	// ܷ  frame ϴ. ȣ  stack arguments 迭 stackframe   ˴ϴ.
+	struct frame_guard
+	{
+		~frame_guard()
+		{
+			stackframe.pop_back();
+			if (!stackframe.empty())
+				this_var = stackframe.front().this_var;
+			else
+				this_var = variable::object(global_object);
+		}
+	} guard;
+
+	if (!templ->is_native)
+	{
+		if (templ->tier < 2 && !templ->jit_failed && templ->call_count != UINT32_MAX)
+		{
+			++templ->call_count;
+			std::uint32_t hotness = function_hotness(*templ);
+			if (hotness >= jit_threshold)
+				promote_function(fn, 2);
+			else if (templ->tier == 0 && hotness >= warm_threshold)
+				promote_function(fn, 1);
+		}
+
+		if (templ->jit_entry != nullptr)
+			return jit_run(*templ);
+		return eval_expr(*templ->expr);
+	}
+	else
+	{
+		return templ->native_fn(this_var, arguments);
+	}
+}
+
+void assign_local(s_string* name, variable val)
+{
+	auto pit = find_frame_local(name);
+	if (pit)
+	{
+		(*pit)->second = val;
+	}
+	else if (stackframe.empty() || find_member(global_object, name))
+	{
+		// global  prototype  object ̹Ƿ setf  ϴ.
+		set_member(global_object, name, val);
+	}
+	else
+	{
+		register_frame_name(name);
+		stackframe.front().blocks.front().insert({ name, val });
+	}
+}
+
+s_function* find_method(variable obj, s_string* name)
+{
+	if (obj.type != var_type::object || obj.v_object == nullptr)
+		return nullptr;
+
+	variable fn = get_member(obj.v_object, name);
+	if (is_function_value(fn))
+		return (s_function*)fn.v_object;
+	return nullptr;
+}
+
+bool is_record_field(variable obj, s_string* name)
+{
+	if (obj.type != var_type::object || obj.v_object == nullptr || obj.v_object->type != object_type::record)
+		return false;
+	return record_column(((s_record*)obj.v_object)->owner, name) != nullptr;
+}
+
+s_array* prepare_arguments(s_function* fn, s_array& local)
+{
+	if (fn->templ->arguments_escape)
+		return create_array();
+
+	init_frame_local_array(local);
+	return &local;
+}
+
+bool analyze_arguments_escape(const expression& body)
+{
+	if (body.type == expr_type::atom)
+		return std::strcmp(body.value->ptr, "arguments") == 0;
+
+	if (body.type == expr_type::list)
+	{
+		for (const auto& sub : body.list)
+		{
+			if (analyze_arguments_escape(sub))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+// atom keyword handler
+
+variable eval_expr_keyword_global(eval_context& context)
+{
+	return variable::object(global_object);
+}
+
+variable eval_expr_keyword_this(eval_context& context)
+{
+	return this_var;
+}
+
+variable eval_expr_keyword_undefined(eval_context& context)
+{
+	return variable::undefined();
+}
+
+variable eval_expr_keyword_null(eval_context& context)
+{
+	return variable::object(nullptr);
+}
+
+variable eval_expr_keyword_true(eval_context & context)
+{
+	return variable::boolean(true);
+}
+
+variable eval_expr_keyword_false(eval_context & context)
+{
+	return variable::boolean(false);
+}
+
+variable eval_expr_keyword_prev(eval_context& context)
+{
+	return prev_var;
+}
+
+variable eval_expr_keyword_arguments(eval_context& context)
+{
+	if (!stackframe.empty())
+	{
+		frame_entry& frame = stackframe.front();
+		if (frame.arguments->frame_local)
+			frame.arguments = promote_array(frame.arguments);
+
+		return variable::object(frame.arguments->obj());
+	}
+	else
+	{
+		return variable::undefined();
+	}
+}
+
+variable eval_expr_keyword_dotdotdot_(eval_context& context)
+{
+	throw invalid_keyword_atom();
+}
+
+// list keyword handler
+
+std::shared_ptr<function_template> compile_function_template(const expression& expr)
+{
+	const expression* params;
+	const expression* body;
+
+	if (expr.list.size() == 3)
+	{
+		params = &expr.list[1];
+		body = &expr.list[2];
+	}
+	else if (expr.list.size() == 4)
+	{
+		if (expr.list[1].type != expr_type::atom)
+			throw invalid_keyword_list();
+		params = &expr.list[2];
+		body = &expr.list[3];
+	}
+	else
+	{
+		throw invalid_keyword_list();
+	}
+
+	if (params->type != expr_type::list)
+		throw invalid_keyword_list();
+
+	gc_vector<s_string*> par;
+	bool is_variadic = false;
+	for (const auto& p : params->list)
+	{
+		if (is_variadic)
+			throw invalid_keyword_list();
+
+		if (p.type != expr_type::atom)
+			throw invalid_keyword_list();
+
+		if (strcmp(p.value->ptr, "...") == 0)
+		{
+			is_variadic = true;
+			continue;
+		}
+		else if (is_keyword(p.value->ptr))
+		{
+			throw invalid_atom_error();
+		}
+
+		par.emplace_back(p.value);
+	}
+
+	return make_function_template(par, *body, is_variadic);
+}
+
+variable eval_expr_keyword_func(const expression& expr, eval_context& context)
+{
+	if (!expr.fn_template)
+		expr.fn_template = compile_function_template(expr);
+
+	s_string* name = nullptr;
+	bool ctor = false;
+
+	if (expr.list.size() == 4)
+	{
+		name = expr.list[1].value;
+		ctor = true;
+	}
+
+	s_function* fn = create_function(expr.fn_template.get(), expr.root.lock());
+	if (ctor)
+		define_constructor(fn, name);
+
+	return variable::object(fn->obj());
+}
+
+void define_constructor(s_function* fn, s_string* name)
+{
+	s_object* prototype = create_object();
+	prototype->name = name;
+	fn->obj()->vars[str_prototype] = prototype->var();
+
+	assign_local(name, fn->var());
+}
+
+variable eval_expr_keyword_new(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() < 2)
+		throw invalid_keyword_list();
+
+	variable v_ctor = eval_expr(expr.list[1]);
+	if (v_ctor.type != var_type::object)
+		throw not_object_error();
+	if (v_ctor.v_object->type != object_type::function)
+		throw not_function_error();
+
+	s_function* ctor = (s_function*)v_ctor.v_object;
+
+	s_array local_arguments;
+	s_array* arguments = prepare_arguments(ctor, local_arguments);
+
+	for (auto it = expr.list.begin() + 2; it != expr.list.end(); ++it)
+	{
+		arguments->vector.push_back(eval_expr(*it));
+	}
+
+	return construct_object(ctor, arguments);
+}
+
+variable construct_object(s_function* ctor, s_array* arguments)
+{
+	if (ctor->obj() == f_Map)
+	{
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		return variable::object(create_map()->obj());
+	}
+	if (ctor->obj() == f_StringBuilder)
+	{
+		if (arguments->vector.size() != 0)
+			throw invalid_arg_error();
+		return variable::object(create_string_builder()->obj());
+	}
+
+	s_object* obj = create_object();
+	auto pit = find_member(ctor->obj(), str_prototype);
+	if (pit)
+	{
+		if ((*pit)->second.type != var_type::object)
+			throw not_object_error();
+		obj->proto = (*pit)->second.v_object;
+	}
+
+	if (ctor->ctor_count >= s_function::slack_tracking_count)
+		obj->vars.reserve(ctor->ctor_fields);
+
+	call_function(ctor, variable::object(obj), arguments);
+
+	if (ctor->ctor_count < s_function::slack_tracking_count)
+	{
+		++ctor->ctor_count;
+		std::size_t fields = std::min<std::size_t>(obj->vars.size(), s_function::slack_tracking_limit);
+		ctor->ctor_fields = std::max(ctor->ctor_fields, static_cast<std::uint32_t>(fields));
+	}
+
+	return variable::object(obj);
+}
+
+variable eval_expr_keyword_array(const expression & expr, eval_context & context)
+{
+	s_array* ret = create_array(elements_kind::packed_int);
+	for (auto it = expr.list.begin() + 1; it != expr.list.end(); ++it)
+	{
+		ret->push_back(eval_expr(*it));
+	}
+
+	return variable::object(ret->obj());
+}
+
+variable eval_expr_keyword_getf(const expression& expr, eval_context& context)
+{
+	s_object* obj;
+	s_string* var_name;
+
+	if (expr.list.size() == 3)
+	{
+		variable tmp = eval_expr(expr.list[1]);
+		if (tmp.type != var_type::object)
+			throw not_object_error();
+		obj = tmp.v_object;
+
+		if (expr.list[2].type != expr_type::atom)
+			throw invalid_keyword_list();
+		var_name = expr.list[2].value;
+	}
+	else if (expr.list.size() == 2)
+	{
+		if (this_var.type != var_type::object)
+			throw not_object_error();
+		obj = this_var.v_object;
+
+		if (expr.list[1].type != expr_type::atom)
+			throw invalid_keyword_list();
+		var_name = expr.list[1].value;
+	}
+	else
+	{
+		throw invalid_keyword_list();
+	}
+
+	if (obj == nullptr)
+		throw null_reference_error();
+
+	return get_member(obj, var_name);
+}
+
+variable eval_expr_keyword_setf(const expression& expr, eval_context& context)
+{
+	s_object* obj;
+	s_string* var_name;
+	const expression* expr_val;
+
+	if (expr.list.size() == 4)
+	{
+		variable tmp = eval_expr(expr.list[1]);
+		if (tmp.type != var_type::object)
+			throw not_object_error();
+		obj = tmp.v_object;
+
+		if (expr.list[2].type != expr_type::atom)
+			throw invalid_keyword_list();
+		var_name = expr.list[2].value;
+
+		expr_val = &expr.list[3];
+	}
+	else if (expr.list.size() == 3)
+	{
+		if (this_var.type != var_type::object)
+			throw not_object_error();
+		obj = this_var.v_object;
+
+		if (expr.list[1].type != expr_type::atom)
+			throw invalid_keyword_list();
+		var_name = expr.list[1].value;
+
+		expr_val = &expr.list[2];
+	}
+	else
+	{
+		throw invalid_keyword_list();
+	}
+
+	if (obj == nullptr)
+		throw null_reference_error();
+
+	variable val = eval_expr(*expr_val);
+	set_member(obj, var_name, val);
+
+	return val;
+}
+
+variable eval_expr_keyword_getl(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() != 2)
+		throw invalid_keyword_list();
+
+	if (expr.list[1].type != expr_type::atom)
+		throw invalid_keyword_list();
+
+	return load_local(expr.list[1]);
+}
+
+variable eval_expr_keyword_setl(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() != 3)
+		throw invalid_keyword_list();
+
+	s_string* var_name;
+
+	if (expr.list[1].type != expr_type::atom)
+		throw invalid_keyword_list();
+	var_name = expr.list[1].value;
+
+	variable val = eval_expr(expr.list[2]);
+	assign_local(var_name, val);
+
+	return val;
+}
+
+variable eval_expr_keyword_geti(const expression & expr, eval_context & context)
+{
+	if (expr.list.size() != 3)
+		throw invalid_keyword_list();
+
+	s_object* obj;
+	s_string* var_name;
+
+	variable tmp = eval_expr(expr.list[1]);
+	if (tmp.type != var_type::object)
+		throw not_object_error();
+	if (tmp.v_object == nullptr)
+		throw null_reference_error();
+	obj = tmp.v_object;
+
+	tmp = eval_expr(expr.list[2]);
+	if (tmp.type != var_type::object)
+		throw not_string_error();
+	if (tmp.v_object == nullptr)
+		throw not_string_error();
+	if (tmp.v_object->type != object_type::string)
+		throw not_string_error();
+	//  ߿  key interned string ٲٸ  ̸ ͷ 񱳵˴ϴ.
+	var_name = find_interned((s_string*)tmp.v_object);
+
+	return get_member(obj, var_name);
+}
+
+variable eval_expr_keyword_seti(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() != 4)
+		throw invalid_keyword_list();
+
+	s_object* obj;
+	s_string* var_name;
+
+	variable tmp = eval_expr(expr.list[1]);
+	if (tmp.type != var_type::object)
+		throw not_object_error();
+	if (tmp.v_object == nullptr)
+		throw null_reference_error();
+	obj = tmp.v_object;
+
+	tmp = eval_expr(expr.list[2]);
+	if (tmp.type != var_type::object)
+		throw not_string_error();
+	if (tmp.v_object == nullptr)
+		throw not_string_error();
+	if (tmp.v_object->type != object_type::string)
+		throw not_string_error();
+	var_name = find_interned((s_string*)tmp.v_object);
+
+	variable val = eval_expr(expr.list[3]);
+	set_member(obj, var_name, val);
+
+	return val;
+}
+
+variable eval_expr_keyword_do(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() <= 1)
+		throw invalid_keyword_list();
+
+	variable ret;
+
+	for (auto it = std::next(expr.list.cbegin()); it != expr.list.cend(); ++it)
+	{
+		ret = eval_expr(*it);
+		prev_var = ret;
+	}
+
+	prev_var = variable::undefined();
+	return ret;
+}
+
+variable eval_expr_keyword_if(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() != 4)
+		throw invalid_keyword_list();
+
+	bool cond = eval_condition(expr.list[1]);
+	if (cond)
+	{
+		return eval_expr(expr.list[2]);
+	}
+	else
+	{
+		return eval_expr(expr.list[3]);
+	}
+}
+
+variable eval_expr_keyword_while(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() != 3)
+		throw invalid_keyword_list();
+
+	variable ret = variable::undefined();
+
+	// ֻ native Լ ȿ   tier ø Լ ϴ.
+	s_function* fn = nullptr;
+	if (!stackframe.empty() && !stackframe.back().function->templ->is_native)
+		fn = stackframe.back().function;
+
+	while (eval_condition(expr.list[1]))
+	{
+		ret = eval_expr(expr.list[2]);
+		prev_var = ret;
+		if (fn != nullptr)
+			count_backedge(fn);
+	}
+
+	prev_var = variable::undefined();
+	return ret;
+}
+
+variable eval_expr_keyword_plus_(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() < 2)
+		throw invalid_keyword_list();
+
+	double ret = 0;
+	for (auto it = expr.list.begin() + 1; it != expr.list.end(); ++it)
+	{
+		variable v = eval_expr(*it);
+		record_feedback(expr, v);
+		if (v.type != var_type::number)
+			throw not_number_error();
+		ret += v.v_number;
+	}
+
+	quicken(expr, quick_number_value, quick_plus_number);
+	return variable::number(ret);
+}
+
+variable eval_expr_keyword_minus_(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() == 2)
+	{
+		variable v = eval_expr(expr.list[1]);
+		record_feedback(expr, v);
+		if (v.type != var_type::number)
+			throw not_number_error();
+
+		quicken(expr, quick_number_value, quick_minus_number);
+		return variable::number(-v.v_number);
+	}
+	else if (expr.list.size() == 3)
+	{
+		variable v1 = eval_expr(expr.list[1]);
+		record_feedback(expr, v1);
+		if (v1.type != var_type::number)
+			throw not_number_error();
+
+		variable v2 = eval_expr(expr.list[2]);
+		record_feedback(expr, v2);
+		if (v2.type != var_type::number)
+			throw not_number_error();
+
+		quicken(expr, quick_number_value, quick_minus_number);
+		return variable::number(v1.v_number - v2.v_number);
+	}
+	else
+	{
+		throw invalid_keyword_list();
+	}
+}
+
+variable eval_expr_keyword_multiply_(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() < 2)
+		throw invalid_keyword_list();
+
+	double ret = 1;
+	for (auto it = expr.list.begin() + 1; it != expr.list.end(); ++it)
+	{
+		variable v = eval_expr(*it);
+		record_feedback(expr, v);
+		if (v.type != var_type::number)
+			throw not_number_error();
+		ret *= v.v_number;
+	}
+
+	quicken(expr, quick_number_value, quick_multiply_number);
+	return variable::number(ret);
+}
+
+variable eval_expr_keyword_division_(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() != 3)
+		throw invalid_keyword_list();
+
+	variable v1 = eval_expr(expr.list[1]);
+	record_feedback(expr, v1);
+	if (v1.type != var_type::number)
+		throw not_number_error();
+
+	variable v2 = eval_expr(expr.list[2]);
+	record_feedback(expr, v2);
+	if (v2.type != var_type::number)
+		throw not_number_error();
+
+	quicken(expr, quick_number_value, quick_division_number);
+	return variable::number(v1.v_number / v2.v_number);
+}
+
+variable eval_expr_keyword_modulo_(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() != 3)
+		throw invalid_keyword_list();
+
+	variable v1 = eval_expr(expr.list[1]);
+	record_feedback(expr, v1);
+	if (v1.type != var_type::number)
+		throw not_number_error();
+
+	variable v2 = eval_expr(expr.list[2]);
+	record_feedback(expr, v2);
+	if (v2.type != var_type::number)
+		throw not_number_error();
+
+	quicken(expr, quick_number_value, quick_modulo_number);
+	return variable::number(std::fmod(v1.v_number, v2.v_number));
+}
+
+variable eval_expr_keyword_idiv(const expression & expr, eval_context & context)
+{
+	if (expr.list.size() != 3)
+		throw invalid_keyword_list();
+
+	variable v1 = eval_expr(expr.list[1]);
+	if (v1.type != var_type::number)
+		throw not_number_error();
+
+	variable v2 = eval_expr(expr.list[2]);
+	if (v2.type != var_type::number)
+		throw not_number_error();
+
+	std::int64_t ret = to_integer(v1.v_number) / to_integer(v2.v_number);
+	return variable::number(static_cast<double>(ret));
+}
+
+variable eval_expr_keyword_imod(const expression & expr, eval_context & context)
+{
+	if (expr.list.size() != 3)
+		throw invalid_keyword_list();
+
+	variable v1 = eval_expr(expr.list[1]);
+	if (v1.type != var_type::number)
+		throw not_number_error();
+
+	variable v2 = eval_expr(expr.list[2]);
+	if (v2.type != var_type::number)
+		throw not_number_error();
+
+	std::int64_t ret = to_integer(v1.v_number) % to_integer(v2.v_number);
+	return variable::number(static_cast<double>(ret));
+}
+
+variable eval_expr_keyword_bitand_(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() != 3)
+		throw invalid_keyword_list();
+
+	variable v1 = eval_expr(expr.list[1]);
+	if (v1.type != var_type::number)
+		throw not_number_error();
+
+	variable v2 = eval_expr(expr.list[2]);
+	if (v2.type != var_type::number)
+		throw not_number_error();
+
+	std::int64_t ret = to_integer(v1.v_number) & to_integer(v2.v_number);
+	return variable::number(static_cast<double>(ret));
+}
+
+variable eval_expr_keyword_bitor_(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() != 3)
+		throw invalid_keyword_list();
+
+	variable v1 = eval_expr(expr.list[1]);
+	if (v1.type != var_type::number)
+		throw not_number_error();
+
+	variable v2 = eval_expr(expr.list[2]);
+	if (v2.type != var_type::number)
+		throw not_number_error();
+
+	std::int64_t ret = to_integer(v1.v_number) | to_integer(v2.v_number);
+	return variable::number(static_cast<double>(ret));
+}
+
+variable eval_expr_keyword_bitxor_(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() != 3)
+		throw invalid_keyword_list();
+
+	variable v1 = eval_expr(expr.list[1]);
+	if (v1.type != var_type::number)
+		throw not_number_error();
+
+	variable v2 = eval_expr(expr.list[2]);
+	if (v2.type != var_type::number)
+		throw not_number_error();
+
+	std::int64_t ret = to_integer(v1.v_number) ^ to_integer(v2.v_number);
+	return variable::number(static_cast<double>(ret));
+}
+
+variable eval_expr_keyword_and(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() < 2)
+		throw invalid_keyword_list();
+
+	for (auto it = expr.list.begin() + 1; it != expr.list.end(); ++it)
+	{
+		if (!eval_condition(*it))
+			return variable::boolean(false);
+	}
+
+	return variable::boolean(true);
+}
+
+variable eval_expr_keyword_or(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() < 2)
+		throw invalid_keyword_list();
+
+	for (auto it = expr.list.begin() + 1; it != expr.list.end(); ++it)
+	{
+		if (eval_condition(*it))
+			return variable::boolean(true);
+	}
+
+	return variable::boolean(false);
+}
+
+variable eval_expr_keyword_not(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() != 2)
+		throw invalid_keyword_list();
+
+	return variable::boolean(!eval_condition(expr.list[1]));
+}
+
+variable eval_expr_keyword_eq_(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() != 3)
+		throw invalid_keyword_list();
+
+	variable v1 = eval_expr(expr.list[1]);
+	record_feedback(expr, v1);
+	variable v2 = eval_expr(expr.list[2]);
+	record_feedback(expr, v2);
+
+	quicken(expr, quick_eq_number);
+	return variable::boolean(v1 == v2);
+}
+
+variable eval_expr_keyword_ne_(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() != 3)
+		throw invalid_keyword_list();
+
+	variable v1 = eval_expr(expr.list[1]);
+	record_feedback(expr, v1);
+	variable v2 = eval_expr(expr.list[2]);
+	record_feedback(expr, v2);
+
+	quicken(expr, quick_ne_number);
+	return variable::boolean(v1 != v2);
+}
+
+variable eval_expr_keyword_lt_(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() != 3)
+		throw invalid_keyword_list();
+
+	variable v1 = eval_expr(expr.list[1]);
+	record_feedback(expr, v1);
+	if (v1.type != var_type::number)
+		throw not_number_error();
+
+	variable v2 = eval_expr(expr.list[2]);
+	record_feedback(expr, v2);
+	if (v2.type != var_type::number)
+		throw not_number_error();
+
+	quicken(expr, quick_lt_number);
+	return variable::boolean(v1.v_number < v2.v_number);
+}
+
+variable eval_expr_keyword_lte_(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() != 3)
+		throw invalid_keyword_list();
+
+	variable v1 = eval_expr(expr.list[1]);
+	record_feedback(expr, v1);
+	if (v1.type != var_type::number)
+		throw not_number_error();
+
+	variable v2 = eval_expr(expr.list[2]);
+	record_feedback(expr, v2);
+	if (v2.type != var_type::number)
+		throw not_number_error();
+
+	quicken(expr, quick_lte_number);
+	return variable::boolean(v1.v_number <= v2.v_number);
+}
+
+variable eval_expr_keyword_gt_(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() != 3)
+		throw invalid_keyword_list();
+
+	variable v1 = eval_expr(expr.list[1]);
+	record_feedback(expr, v1);
+	if (v1.type != var_type::number)
+		throw not_number_error();
+
+	variable v2 = eval_expr(expr.list[2]);
+	record_feedback(expr, v2);
+	if (v2.type != var_type::number)
+		throw not_number_error();
+
+	quicken(expr, quick_gt_number);
+	return variable::boolean(v1.v_number > v2.v_number);
+}
+
+variable eval_expr_keyword_gte_(const expression& expr, eval_context& context)
+{
+	if (expr.list.size() != 3)
+		throw invalid_keyword_list();
+
+	variable v1 = eval_expr(expr.list[1]);
+	record_feedback(expr, v1);
+	if (v1.type != var_type::number)
+		throw not_number_error();
+
+	variable v2 = eval_expr(expr.list[2]);
+	record_feedback(expr, v2);
+	if (v2.type != var_type::number)
+		throw not_number_error();
+
+	quicken(expr, quick_gte_number);
+	return variable::boolean(v1.v_number >= v2.v_number);
+}
+
+// type feedback handler
+
+void deoptimize(const expression& expr, variable seen)
+{
+	record_feedback(expr, seen);
+	expr.handler = nullptr;
+	expr.number_handler = nullptr;
+	++expr.deopts;
+}
+
+// number ; ϴ operandԴϴ. literal number  node ˻ ʽϴ.
+inline double quick_number_operand(const expression& site, const expression& operand)
+{
+	if (operand.type == expr_type::number)
+		return operand.number;
+	if (operand.number_handler != nullptr)
+		return operand.number_handler(operand);
+	if (operand.inferred == static_type::number)
+		return eval_expr(operand).v_number;
+
+	variable v = eval_expr(operand);
+	if (v.type != var_type::number)
+	{
+		deoptimize(site, v);
+		throw not_number_error();
+	}
+	return v.v_number;
+}
+
+inline variable quick_value_operand(const expression& operand)
+{
+	if (operand.type == expr_type::number)
+		return variable::number(operand.number);
+	if (operand.number_handler != nullptr)
+		return variable::number(operand.number_handler(operand));
+	return eval_expr(operand);
+}
+
+variable quick_number_value(const expression& expr, eval_context& context)
+{
+	return variable::number(expr.number_handler(expr));
+}
+
+double quick_plus_number(const expression& expr)
+{
+	double ret = 0;
+	for (auto it = expr.list.begin() + 1; it != expr.list.end(); ++it)
+		ret += quick_number_operand(expr, *it);
+	return ret;
+}
+
+double quick_minus_number(const expression& expr)
+{
+	if (expr.list.size() == 2)
+		return -quick_number_operand(expr, expr.list[1]);
+
+	double v1 = quick_number_operand(expr, expr.list[1]);
+	double v2 = quick_number_operand(expr, expr.list[2]);
+	return v1 - v2;
+}
+
+double quick_multiply_number(const expression& expr)
+{
+	double ret = 1;
+	for (auto it = expr.list.begin() + 1; it != expr.list.end(); ++it)
+		ret *= quick_number_operand(expr, *it);
+	return ret;
+}
+
+double quick_division_number(const expression& expr)
+{
+	double v1 = quick_number_operand(expr, expr.list[1]);
+	double v2 = quick_number_operand(expr, expr.list[2]);
+	return v1 / v2;
+}
+
+double quick_modulo_number(const expression& expr)
+{
+	double v1 = quick_number_operand(expr, expr.list[1]);
+	double v2 = quick_number_operand(expr, expr.list[2]);
+	return std::fmod(v1, v2);
+}
+
+variable quick_lt_number(const expression& expr, eval_context& context)
+{
+	double v1 = quick_number_operand(expr, expr.list[1]);
+	double v2 = quick_number_operand(expr, expr.list[2]);
+	return variable::boolean(v1 < v2);
+}
+
+variable quick_lte_number(const expression& expr, eval_context& context)
+{
+	double v1 = quick_number_operand(expr, expr.list[1]);
+	double v2 = quick_number_operand(expr, expr.list[2]);
+	return variable::boolean(v1 <= v2);
+}
+
+variable quick_gt_number(const expression& expr, eval_context& context)
+{
+	double v1 = quick_number_operand(expr, expr.list[1]);
+	double v2 = quick_number_operand(expr, expr.list[2]);
+	return variable::boolean(v1 > v2);
+}
+
+variable quick_gte_number(const expression& expr, eval_context& context)
+{
+	double v1 = quick_number_operand(expr, expr.list[1]);
+	double v2 = quick_number_operand(expr, expr.list[2]);
+	return variable::boolean(v1 >= v2);
+}
+
+// = /= type ޶ ܰ Ƿ, ˻翡 ϸ ǵ⸸ ϰ Ϲ 񱳸 մϴ.
+variable quick_eq_number(const expression& expr, eval_context& context)
+{
+	variable v1 = quick_value_operand(expr.list[1]);
+	variable v2 = quick_value_operand(expr.list[2]);
+	if (v1.type != var_type::number)
+		deoptimize(expr, v1);
+	else if (v2.type != var_type::number)
+		deoptimize(expr, v2);
+	return variable::boolean(v1 == v2);
+}
+
+variable quick_ne_number(const expression& expr, eval_context& context)
+{
+	variable v1 = quick_value_operand(expr.list[1]);
+	variable v2 = quick_value_operand(expr.list[2]);
+	if (v1.type != var_type::number)
+		deoptimize(expr, v1);
+	else if (v2.type != var_type::number)
+		deoptimize(expr, v2);
+	return variable::boolean(v1 != v2);
+}
+
+void dump_type_feedback(std::ostream& strm, const expression& body)
+{
+	static const char* const type_names[] = { "boolean", "number", "undefined", "object" };
+
+	std::function<void(const expression&)> visit = [&](const expression& expr) {
+		if (expr.feedback != 0)
+		{
+			std::string types;
+			for (int i = 0; i < 4; ++i)
+			{
+				if (expr.feedback & (1 << i))
+				{
+					if (!types.empty())
+						types += '|';
+					types += type_names[i];
+				}
+			}
+
+			bool quickened = expr.number_handler != nullptr
+				|| expr.handler == quick_lt_number || expr.handler == quick_lte_number
+				|| expr.handler == quick_gt_number || expr.handler == quick_gte_number
+				|| expr.handler == quick_eq_number || expr.handler == quick_ne_number;
+			const char* state = quickened ? "number" : "generic";
+
+			strm << std::left << std::setw(9) << state << std::setw(28) << types
+				<< std::right << std::setw(8) << expr.samples << std::setw(8) << expr.deopts
+				<< "  " << expr_to_string(expr) << "\n";
+		}
+
+		for (const auto& sub : expr.list)
+			visit(sub);
+	};
+
+	strm << std::left << std::setw(9) << "state" << std::setw(28) << "types"
+		<< std::right << std::setw(8) << "samples" << std::setw(8) << "deopts" << "  site\n";
+	visit(body);
+	strm << std::right;
+	strm.flush();
+}
+
+// static type inference
+
+//  ̸  typeԴϴ.   dynamicԴϴ.
+using type_env = std::unordered_map<s_string*, static_type, pstr_hash, pstr_equal>;
+
+inline static_type join_type(static_type t1, static_type t2)
+{
+	return t1 == t2 ? t1 : static_type::dynamic;
+}
+
+//  帧  Դϴ. ʿ  type   ϴ.
+void join_env(type_env& env, const type_env& other)
+{
+	for (auto it = env.begin(); it != env.end();)
+	{
+		auto oit = other.find(it->first);
+		if (oit == other.end() || oit->second != it->second)
+			it = env.erase(it);
+		else
+			++it;
+	}
+}
+
+void set_env(type_env& env, s_string* name, static_type type)
+{
+	if (type == static_type::dynamic)
+		env.erase(name);
+	else
+		env[name] = type;
+}
+
+// list expression keyword handlerԴϴ. Լ ȣ̸ nullptrԴϴ.
+list_keyword_fn find_list_keyword(const expression& expr)
+{
+	if (expr.list.empty() || expr.list.front().type != expr_type::atom)
+		return nullptr;
+
+	auto it = list_keyword_map.find(expr.list.front().value->ptr);
+	if (it == list_keyword_map.end())
+		return nullptr;
+	return it->second;
+}
+
+// operand number ˻ϴ keyword operand  number   handler ݴϴ.
+bool number_check_handler(const expression& expr, list_keyword_fn keyword, list_keyword_fn& handler, number_fn& number_handler)
+{
+	std::size_t size = expr.list.size();
+
+	handler = quick_number_value;
+	number_handler = nullptr;
+
+	if (keyword == eval_expr_keyword_plus_ && size >= 2)
+		number_handler = quick_plus_number;
+	else if (keyword == eval_expr_keyword_minus_ && (size == 2 || size == 3))
+		number_handler = quick_minus_number;
+	else if (keyword == eval_expr_keyword_multiply_ && size >= 2)
+		number_handler = quick_multiply_number;
+	else if (keyword == eval_expr_keyword_division_ && size == 3)
+		number_handler = quick_division_number;
+	else if (keyword == eval_expr_keyword_modulo_ && size == 3)
+		number_handler = quick_modulo_number;
+	else if (keyword == eval_expr_keyword_lt_ && size == 3)
+		handler = quick_lt_number;
+	else if (keyword == eval_expr_keyword_lte_ && size == 3)
+		handler = quick_lte_number;
+	else if (keyword == eval_expr_keyword_gt_ && size == 3)
+		handler = quick_gt_number;
+	else if (keyword == eval_expr_keyword_gte_ && size == 3)
+		handler = quick_gte_number;
+	else
+		return false;
+
+	return true;
+}
+
+// operand  ˻ϴ keyword 
+bool is_condition_keyword(list_keyword_fn keyword)
+{
+	return keyword == eval_expr_keyword_if || keyword == eval_expr_keyword_while
+		|| keyword == eval_expr_keyword_and || keyword == eval_expr_keyword_or
+		|| keyword == eval_expr_keyword_not;
+}
+
+static_type infer_expr(const expression& expr, type_env& env);
+
+static_type infer_list(const expression& expr, type_env& env)
+{
+	const auto& list = expr.list;
+	list_keyword_fn keyword = find_list_keyword(expr);
+
+	if (keyword == nullptr || keyword == eval_expr_keyword_new)
+	{
+		// ȣ Լ dynamic scope  Լ  ٲ  ֽϴ.
+		for (const auto& sub : list)
+			infer_expr(sub, env);
+		env.clear();
+		return static_type::dynamic;
+	}
+	else if (keyword == eval_expr_keyword_setf || keyword == eval_expr_keyword_seti)
+	{
+		// target global object  ̸  ٲϴ. target   Ƿ ȣó մϴ.
+		for (auto it = list.begin() + 1; it != list.end(); ++it)
+			infer_expr(*it, env);
+		env.clear();
+		return static_type::dynamic;
+	}
+	else if (keyword == eval_expr_keyword_func)
+	{
+		//   func ó 򰡵   ߷մϴ. ̸    Լ ϴ.
+		if (list.size() == 4 && list[1].type == expr_type::atom)
+			env.erase(list[1].value);
+		return static_type::dynamic;
+	}
+	else if (keyword == eval_expr_keyword_getl)
+	{
+		if (list.size() != 2 || list[1].type != expr_type::atom)
+			return static_type::dynamic;
+
+		auto it = env.find(list[1].value);
+		return it != env.end() ? it->second : static_type::dynamic;
+	}
+	else if (keyword == eval_expr_keyword_setl)
+	{
+		if (list.size() != 3 || list[1].type != expr_type::atom)
+			return static_type::dynamic;
+
+		static_type type = infer_expr(list[2], env);
+		set_env(env, list[1].value, type);
+		return type;
+	}
+	else if (keyword == eval_expr_keyword_if && list.size() == 4)
+	{
+		infer_expr(list[1], env);
+
+		type_env else_env = env;
+		static_type t1 = infer_expr(list[2], env);
+		static_type t2 = infer_expr(list[3], else_env);
+		join_env(env, else_env);
+		return join_type(t1, t2);
+	}
+	else if (keyword == eval_expr_keyword_while && list.size() == 3)
+	{
+		//    type loop   type ļ  ٲ   ݺմϴ.
+		//    head ̹Ƿ ׶  annotation  ݺ մϴ.
+		type_env head = env;
+		for (;;)
+		{
+			type_env body = head;
+			infer_expr(list[1], body);
+			type_env exit = body;
+			infer_expr(list[2], body);
+			join_env(body, env);
+
+			if (body == head)
+			{
+				env = std::move(exit);
+				break;
+			}
+			head = std::move(body);
+		}
+		return static_type::dynamic;
+	}
+	else if ((keyword == eval_expr_keyword_and || keyword == eval_expr_keyword_or) && list.size() >= 2)
+	{
+		// ù operand ڷδ 򰡵   Ƿ,  operand  帧  Ĩϴ.
+		infer_expr(list[1], env);
+		type_env out = env;
+		for (auto it = list.begin() + 2; it != list.end(); ++it)
+		{
+			infer_expr(*it, env);
+			join_env(out, env);
+		}
+		env = std::move(out);
+		return static_type::boolean;
+	}
+
+	static_type last = static_type::dynamic;
+	bool numbers = true;
+	for (auto it = list.begin() + 1; it != list.end(); ++it)
+	{
+		last = infer_expr(*it, env);
+		if (last != static_type::number)
+			numbers = false;
+	}
+
+	list_keyword_fn handler;
+	number_fn number_handler;
+	if (number_check_handler(expr, keyword, handler, number_handler))
+	{
+		if (numbers)
+		{
+			expr.handler = handler;
+			expr.number_handler = number_handler;
+		}
+		return number_handler != nullptr ? static_type::number : static_type::boolean;
+	}
+
+	if (keyword == eval_expr_keyword_idiv || keyword == eval_expr_keyword_imod
+		|| keyword == eval_expr_keyword_bitand_ || keyword == eval_expr_keyword_bitor_
+		|| keyword == eval_expr_keyword_bitxor_)
+	{
+		return static_type::number;
+	}
+	if (keyword == eval_expr_keyword_eq_ || keyword == eval_expr_keyword_ne_
+		|| keyword == eval_expr_keyword_not)
+	{
+		return static_type::boolean;
+	}
+	if (keyword == eval_expr_keyword_do && list.size() >= 2)
+		return last;
+
+	return static_type::dynamic;
+}
+
+static_type infer_expr(const expression& expr, type_env& env)
+{
+	static_type type = static_type::dynamic;
+
+	if (expr.type == expr_type::number)
+	{
+		type = static_type::number;
+	}
+	else if (expr.type == expr_type::atom)
+	{
+		if (strcmp(expr.value->ptr, "true") == 0 || strcmp(expr.value->ptr, "false") == 0)
+		{
+			type = static_type::boolean;
+		}
+		else if (atom_keyword_map.find(expr.value->ptr) == atom_keyword_map.end())
+		{
+			auto it = env.find(expr.value);
+			if (it != env.end())
+				type = it->second;
+		}
+	}
+	else if (expr.type == expr_type::list && !expr.list.empty())
+	{
+		type = infer_list(expr, env);
+	}
+
+	expr.inferred = type;
+	return type;
+}
+
+void infer_types(const expression& body)
+{
+	type_env env;
+	infer_expr(body, env);
+}
+
+void dump_static_types(std::ostream& strm, const expression& body)
+{
+	std::size_t sites = 0;
+	std::size_t dynamic_sites = 0;
+
+	std::function<void(const expression&)> visit = [&](const expression& expr) {
+		if (expr.type != expr_type::list)
+			return;
+
+		list_keyword_fn keyword = find_list_keyword(expr);
+		if (keyword == eval_expr_keyword_func)
+			return;
+
+		list_keyword_fn handler;
+		number_fn number_handler;
+		std::string unproven;
+
+		if (number_check_handler(expr, keyword, handler, number_handler))
+		{
+			++sites;
+			for (auto it = expr.list.begin() + 1; it != expr.list.end(); ++it)
+			{
+				if (it->inferred != static_type::number && it->type != expr_type::number)
+					unproven += (unproven.empty() ? "" : ", ") + expr_to_string(*it, 20);
+			}
+		}
+		else if (is_condition_keyword(keyword) && expr.list.size() >= 2)
+		{
+			++sites;
+			const expression& cond = expr.list[1];
+			if (keyword == eval_expr_keyword_and || keyword == eval_expr_keyword_or)
+			{
+				for (auto it = expr.list.begin() + 1; it != expr.list.end(); ++it)
+				{
+					if (it->inferred != static_type::boolean)
+						unproven += (unproven.empty() ? "" : ", ") + expr_to_string(*it, 20);
+				}
+			}
+			else if (cond.inferred != static_type::boolean)
+			{
+				unproven = expr_to_string(cond, 20);
+			}
+		}
+
+		if (!unproven.empty())
+		{
+			++dynamic_sites;
+			strm << std::left << std::setw(32) << unproven << std::right << "  " << expr_to_string(expr) << "\n";
+		}
+
+		for (const auto& sub : expr.list)
+			visit(sub);
+	};
+
+	strm << std::left << std::setw(32) << "unproven operands" << std::right << "  site\n";
+	visit(body);
+	strm << dynamic_sites << " of " << sites << " checked sites are dynamically typed" << std::endl;
+}
+
+// loop invariant hoisting
+
+void mark_loop_sites(expression& expr)
+{
+	if (expr.type != expr_type::list || expr.list.empty())
+		return;
+
+	list_keyword_fn keyword = find_list_keyword(expr);
+	if (keyword == eval_expr_keyword_func)
+		return;
+
+	if (keyword == nullptr && expr.list.size() >= 2 && expr.list[1].type == expr_type::atom)
+	{
+		if (!expr.call_cache)
+			expr.call_cache = std::make_shared<call_site_cache>();
+		expr.call_cache->loop_site = true;
+	}
+
+	for (auto& sub : expr.list)
+		mark_loop_sites(sub);
+}
+
+void hoist_loop_invariants(expression& expr)
+{
+	if (expr.type != expr_type::list || expr.list.empty())
+		return;
+
+	if (find_list_keyword(expr) == eval_expr_keyword_while && expr.list.size() == 3)
+	{
+		mark_loop_sites(expr.list[1]);
+		mark_loop_sites(expr.list[2]);
+	}
+
+	for (auto& sub : expr.list)
+		hoist_loop_invariants(sub);
+}
+
+void optimize_expr(expression& expr)
+{
+	fold_constants(expr);
+	hoist_loop_invariants(expr);
+}
+
+// function inlining
+
+// inline  д  迭Դϴ. eval_inlined_call()  ϴ ȿ ȿմϴ.
+const variable* inline_args = nullptr;
+
+variable eval_inline_argument(const expression& expr, eval_context& context)
+{
+	return inline_args[static_cast<std::size_t>(expr.list[1].number)];
+}
+
+bool is_inline_candidate(const expression& expr, std::size_t& nodes)
+{
+	if (++nodes > inline_node_limit)
+		return false;
+
+	if (expr.type == expr_type::atom)
+		return strcmp(expr.value->ptr, "arguments") != 0;
+	if (expr.type != expr_type::list || expr.list.empty())
+		return true;
+
+	list_keyword_fn keyword = find_list_keyword(expr);
+	if (keyword == nullptr || keyword == eval_expr_keyword_new
+		|| keyword == eval_expr_keyword_func || keyword == eval_expr_keyword_setl)
+	{
+		return false;
+	}
+
+	for (const auto& sub : expr.list)
+	{
+		if (!is_inline_candidate(sub, nodes))
+			return false;
+	}
+	return true;
+}
+
+int parameter_slot(const function_template& templ, const expression& atom)
+{
+	for (std::size_t i = 0; i < templ.parameters.size(); ++i)
+	{
+		if (strcmp(templ.parameters[i]->ptr, atom.value->ptr) == 0)
+			return static_cast<int>(i);
+	}
+	return -1;
+}
+
+// getf setf field ̸ó  ʴ atom operand 
+bool is_name_operand(list_keyword_fn keyword, std::size_t size, std::size_t index)
+{
+	if (keyword == eval_expr_keyword_getf)
+		return (size == 3 && index == 2) || (size == 2 && index == 1);
+	if (keyword == eval_expr_keyword_setf)
+		return (size == 4 && index == 2) || (size == 3 && index == 1);
+	return false;
+}
+
+void make_argument_ref(expression& expr, int slot)
+{
+	expression ref;
+	ref.root = expr.root;
+	ref.type = expr_type::list;
+	ref.list.resize(2);
+	ref.list[0].type = expr_type::atom;
+	ref.list[0].value = create_string("getl");
+	ref.list[1].type = expr_type::number;
+	ref.list[1].number = slot;
+	ref.handler = eval_inline_argument;
+	expr = std::move(ref);
+}
+
+void bind_inline_parameters(expression& expr, const function_template& templ)
+{
+	if (expr.type == expr_type::atom)
+	{
+		if (atom_keyword_map.find(expr.value->ptr) != atom_keyword_map.end())
+			return;
+
+		int slot = parameter_slot(templ, expr);
+		if (slot >= 0)
+			make_argument_ref(expr, slot);
+		return;
+	}
+
+	if (expr.type != expr_type::list || expr.list.empty())
+		return;
+
+	list_keyword_fn keyword = find_list_keyword(expr);
+	if (keyword == eval_expr_keyword_getl)
+	{
+		if (expr.list.size() == 2 && expr.list[1].type == expr_type::atom)
+		{
+			int slot = parameter_slot(templ, expr.list[1]);
+			if (slot >= 0)
+				make_argument_ref(expr, slot);
+		}
+		return;
+	}
+
+	for (std::size_t i = 1; i < expr.list.size(); ++i)
+	{
+		if (!is_name_operand(keyword, expr.list.size(), i))
+			bind_inline_parameters(expr.list[i], templ);
+	}
+}
+
+std::shared_ptr<expression> make_inline_body(const function_template& templ)
+{
+	if (templ.is_native || templ.is_variadic || templ.arguments_escape
+		|| templ.parameters.size() > inline_max_parameters)
+	{
+		return nullptr;
+	}
+
+	std::size_t nodes = 0;
+	if (!is_inline_candidate(*templ.expr, nodes))
+		return nullptr;
+
+	auto body = std::make_shared<expression>(*templ.expr);
+	bind_inline_parameters(*body, templ);
+	return body;
+}
+
+void profile_call_site(const expression& expr, s_function* fn)
+{
+	if (!expr.call_cache)
+		expr.call_cache = std::make_shared<call_site_cache>();
+
+	call_site_cache& cache = *expr.call_cache;
+	if (cache.disabled)
+		return;
+
+	if (cache.target != fn->templ)
+	{
+		cache.target = fn->templ;
+		cache.target_root = fn->expr_root;
+		cache.hits = 0;
+	}
+
+	if (++cache.hits == inline_threshold)
 	{
-		auto it = atom_keyword_map.find(expr.value->ptr);
-		if (it != atom_keyword_map.end())
+		cache.body = make_inline_body(*fn->templ);
+		if (!cache.body)
+			cache.disabled = true;
+	}
+}
+
+void deoptimize_inline(call_site_cache& cache)
+{
+	cache.body.reset();
+	cache.target = nullptr;
+	cache.target_root.reset();
+	cache.hits = 0;
+	if (++cache.deopts >= inline_deopt_limit)
+		cache.disabled = true;
+}
+
+variable eval_inlined_call(const expression& expr, const call_site_cache& cache, s_function* fn, variable new_this)
+{
+	// ڰ callee ٲٰ  call site ٽ  deoptimize_inline() cache Ƿ   ƵӴϴ.
+	std::shared_ptr<expression> body = cache.body;
+	std::shared_ptr<expression> target_root = cache.target_root;
+	const function_template* target = cache.target;
+
+	variable args[inline_max_parameters];
+
+	std::size_t count = 0;
+	for (auto it = expr.list.begin() + 2; it != expr.list.end(); ++it)
+		args[count++] = eval_expr(*it);
+
+	// ׵ site ٸ target ٲٸ  ڷ fn Ϲ ȣմϴ.
+	if (cache.body != body || cache.target != target)
+	{
+		s_array local_arguments;
+		s_array* arguments = prepare_arguments(fn, local_arguments);
+		for (std::size_t i = 0; i < count; ++i)
+			arguments->vector.push_back(args[i]);
+		return call_function(fn, new_this, arguments);
+	}
+
+	for (; count < target->parameters.size(); ++count)
+		args[count] = variable::undefined();
+
+	// call_function() frame    this ǵϴ.
+	struct inline_guard
+	{
+		const variable* saved_args;
+		~inline_guard()
 		{
-			return it->second(context);
+			inline_args = saved_args;
+			if (!stackframe.empty())
+				this_var = stackframe.front().this_var;
+			else
+				this_var = variable::object(global_object);
+		}
+	} guard { inline_args };
+
+	// ڸ ϴ  ٸ call site inline_args ٲٰ ǵǷ,   մϴ.
+	inline_args = args;
+	this_var = new_this;
+
+	return eval_expr(*body);
+}
+
+// Array, typed array intrinsic
+
+namespace
+{
+	// call_function() frame    this ǵϴ.
+	struct intrinsic_exit_guard
+	{
+		~intrinsic_exit_guard()
+		{
+			if (!stackframe.empty())
+				this_var = stackframe.front().this_var;
+			else
+				this_var = variable::object(global_object);
+		}
+	};
+
+	object_type intrinsic_object_type(intrinsic_kind kind)
+	{
+		switch (kind)
+		{
+		case intrinsic_kind::typed_size:
+		case intrinsic_kind::typed_get:
+		case intrinsic_kind::typed_set:
+			return object_type::typed_array;
+		default:
+			return object_type::array;
+		}
+	}
+
+	bool is_plain_receiver(variable var, object_type type)
+	{
+		// ڱ  ִ array prototype method   ֽϴ.
+		return var.type == var_type::object && var.v_object != nullptr
+			&& var.v_object->type == type && var.v_object->vars.empty();
+	}
+
+	// receiver  site intrinsic ״ θ array  object, ƴϸ nullptr ȯմϴ.
+	s_object* intrinsic_receiver(const expression& expr, variable var, intrinsic_kind kind)
+	{
+		if (!is_plain_receiver(var, intrinsic_object_type(kind)))
+			return nullptr;
+
+		call_site_cache& cache = *expr.call_cache;
+		if (cache.intrinsic_shape != shape_epoch)
+		{
+			s_function* fn = find_method(var, expr.list[1].value);
+			if (fn == nullptr || fn->templ->intrinsic != kind)
+				return nullptr;
+			cache.intrinsic_shape = shape_epoch;
+		}
+		return var.v_object;
+	}
+
+	variable deoptimize_intrinsic(const expression& expr, variable var)
+	{
+		expr.handler = eval_expr_call;
+		++expr.call_cache->intrinsic_deopts;
+		return eval_call_with_receiver(expr, var);
+	}
+
+	// array_get, array_set native  index ˻մϴ.
+	std::size_t intrinsic_index(std::size_t size, variable index)
+	{
+		if (index.type != var_type::number)
+			throw invalid_arg_error();
+		try
+		{
+			std::size_t idx = static_cast<std::size_t>(to_integer(index.v_number));
+			if (idx >= size)
+				throw out_of_range_error();
+			return idx;
+		}
+		catch (not_integer_error&)
+		{
+			throw invalid_arg_error();
+		}
+	}
+
+	variable quick_array_size(const expression& expr, eval_context& context)
+	{
+		variable var = eval_expr(expr.list[0]);
+		s_array* arr = (s_array*)intrinsic_receiver(expr, var, intrinsic_kind::array_size);
+		if (arr == nullptr)
+			return deoptimize_intrinsic(expr, var);
+
+		intrinsic_exit_guard guard;
+		return variable::number(arr->size());
+	}
+
+	variable quick_array_get(const expression& expr, eval_context& context)
+	{
+		variable var = eval_expr(expr.list[0]);
+		s_array* arr = (s_array*)intrinsic_receiver(expr, var, intrinsic_kind::array_get);
+		if (arr == nullptr)
+			return deoptimize_intrinsic(expr, var);
+
+		variable index = eval_expr(expr.list[2]);
+
+		intrinsic_exit_guard guard;
+		return arr->get(intrinsic_index(arr->size(), index));
+	}
+
+	variable quick_array_set(const expression& expr, eval_context& context)
+	{
+		variable var = eval_expr(expr.list[0]);
+		s_array* arr = (s_array*)intrinsic_receiver(expr, var, intrinsic_kind::array_set);
+		if (arr == nullptr)
+			return deoptimize_intrinsic(expr, var);
+
+		variable index = eval_expr(expr.list[2]);
+		variable val = eval_expr(expr.list[3]);
+
+		intrinsic_exit_guard guard;
+		arr->set(intrinsic_index(arr->size(), index), val);
+		return val;
+	}
+
+	variable quick_typed_size(const expression& expr, eval_context& context)
+	{
+		variable var = eval_expr(expr.list[0]);
+		s_typed_array* arr = (s_typed_array*)intrinsic_receiver(expr, var, intrinsic_kind::typed_size);
+		if (arr == nullptr)
+			return deoptimize_intrinsic(expr, var);
+
+		intrinsic_exit_guard guard;
+		return variable::number(arr->size);
+	}
+
+	variable quick_typed_get(const expression& expr, eval_context& context)
+	{
+		variable var = eval_expr(expr.list[0]);
+		s_typed_array* arr = (s_typed_array*)intrinsic_receiver(expr, var, intrinsic_kind::typed_get);
+		if (arr == nullptr)
+			return deoptimize_intrinsic(expr, var);
+
+		variable index = eval_expr(expr.list[2]);
+
+		intrinsic_exit_guard guard;
+		return load_element(arr, intrinsic_index(arr->size, index));
+	}
+
+	variable quick_typed_set(const expression& expr, eval_context& context)
+	{
+		variable var = eval_expr(expr.list[0]);
+		s_typed_array* arr = (s_typed_array*)intrinsic_receiver(expr, var, intrinsic_kind::typed_set);
+		if (arr == nullptr)
+			return deoptimize_intrinsic(expr, var);
+
+		variable index = eval_expr(expr.list[2]);
+		variable val = eval_expr(expr.list[3]);
+
+		intrinsic_exit_guard guard;
+		std::size_t idx = intrinsic_index(arr->size, index);
+		store_element(arr, idx, val);
+		return load_element(arr, idx);
+	}
+}
+
+void quicken_intrinsic(const expression& expr, s_function* fn, variable receiver)
+{
+	if (expr.list[1].type != expr_type::atom || !is_plain_receiver(receiver, intrinsic_object_type(fn->templ->intrinsic)))
+		return;
+	if (expr.call_cache && expr.call_cache->intrinsic_deopts >= intrinsic_deopt_limit)
+		return;
+
+	list_keyword_fn handler;
+	switch (fn->templ->intrinsic)
+	{
+	case intrinsic_kind::array_size:
+		handler = (expr.list.size() == 2) ? quick_array_size : nullptr;
+		break;
+	case intrinsic_kind::array_get:
+		handler = (expr.list.size() == 3) ? quick_array_get : nullptr;
+		break;
+	case intrinsic_kind::array_set:
+		handler = (expr.list.size() == 4) ? quick_array_set : nullptr;
+		break;
+	case intrinsic_kind::typed_size:
+		handler = (expr.list.size() == 2) ? quick_typed_size : nullptr;
+		break;
+	case intrinsic_kind::typed_get:
+		handler = (expr.list.size() == 3) ? quick_typed_get : nullptr;
+		break;
+	case intrinsic_kind::typed_set:
+		handler = (expr.list.size() == 4) ? quick_typed_set : nullptr;
+		break;
+	default:
+		handler = nullptr;
+		break;
+	}
+
+	//   ٸ ȣ native ܸ  Ϲ ȣ Ӵϴ.
+	// ̸ ã method ƴ϶ expr.list[1] ؼ  Լ guard ׻ մϴ.
+	if (handler == nullptr || find_method(receiver, expr.list[1].value) != fn)
+		return;
+
+	if (!expr.call_cache)
+		expr.call_cache = std::make_shared<call_site_cache>();
+	expr.call_cache->intrinsic_shape = shape_epoch;
+	expr.handler = handler;
+}
+
+// constant folding
+
+bool is_literal(const expression& expr)
+{
+	if (expr.type == expr_type::number)
+		return true;
+	if (expr.type != expr_type::atom)
+		return false;
+
+	const char* name = expr.value->ptr;
+	return strcmp(name, "true") == 0 || strcmp(name, "false") == 0
+		|| strcmp(name, "null") == 0 || strcmp(name, "undefined") == 0;
+}
+
+// ۿ  operand    keyword 
+bool is_foldable_keyword(list_keyword_fn keyword)
+{
+	static const list_keyword_fn foldable[] = {
+		eval_expr_keyword_plus_, eval_expr_keyword_minus_, eval_expr_keyword_multiply_,
+		eval_expr_keyword_division_, eval_expr_keyword_modulo_, eval_expr_keyword_idiv,
+		eval_expr_keyword_imod, eval_expr_keyword_bitand_, eval_expr_keyword_bitor_,
+		eval_expr_keyword_bitxor_, eval_expr_keyword_and, eval_expr_keyword_or,
+		eval_expr_keyword_not, eval_expr_keyword_eq_, eval_expr_keyword_ne_,
+		eval_expr_keyword_lt_, eval_expr_keyword_lte_, eval_expr_keyword_gt_,
+		eval_expr_keyword_gte_,
+	};
+
+	return std::find(std::begin(foldable), std::end(foldable), keyword) != std::end(foldable);
+}
+
+// literal   մϴ. to_conditional() ܸ  ̸ false ȯմϴ.
+bool literal_conditional(const expression& expr, bool& cond)
+{
+	try
+	{
+		cond = to_conditional(eval_expr(expr));
+		return true;
+	}
+	catch (invalid_conditional&)
+	{
+		return false;
+	}
+}
+
+// 0 ų INT64_MIN -1  idiv, imod 
+// ܰ ƴ϶ hardware trap Ƿ ̸  ʰ   ñϴ.
+bool traps_integer_division(const expression& expr, list_keyword_fn keyword)
+{
+	if (keyword != eval_expr_keyword_idiv && keyword != eval_expr_keyword_imod)
+		return false;
+	if (expr.list.size() != 3 || expr.list[2].type != expr_type::number)
+		return false;
+
+	double divisor = expr.list[2].number;
+	if (divisor == 0.0)
+		return true;
+	return divisor == -1.0 && expr.list[1].type == expr_type::number
+		&& expr.list[1].number == static_cast<double>(INT64_MIN);
+}
+
+void replace_with_literal(expression& expr, variable val)
+{
+	expression lit;
+	lit.root = expr.root;
+	if (val.type == var_type::number)
+	{
+		lit.type = expr_type::number;
+		lit.number = val.v_number;
+	}
+	else
+	{
+		lit.type = expr_type::atom;
+		lit.value = create_string(val.v_boolean ? "true" : "false");
+	}
+	expr = std::move(lit);
+}
+
+void fold_constants(expression& expr)
+{
+	if (expr.type != expr_type::list)
+		return;
+
+	list_keyword_fn keyword = find_list_keyword(expr);
+	if (keyword == eval_expr_keyword_func)
+	{
+		// parameter  expression ƴմϴ.
+		fold_constants(expr.list.back());
+		return;
+	}
+
+	for (auto& sub : expr.list)
+		fold_constants(sub);
+
+	if (keyword == eval_expr_keyword_if && expr.list.size() == 4)
+	{
+		bool cond;
+		if (is_literal(expr.list[1]) && literal_conditional(expr.list[1], cond))
+		{
+			expression branch = std::move(expr.list[cond ? 2 : 3]);
+			expr = std::move(branch);
+		}
+		return;
+	}
+
+	if (!is_foldable_keyword(keyword) || expr.list.size() < 2)
+		return;
+
+	if (keyword == eval_expr_keyword_and || keyword == eval_expr_keyword_or)
+	{
+		//  literal    operand 򰡵 ʽϴ.
+		bool decided = (keyword == eval_expr_keyword_or);
+		for (auto it = expr.list.begin() + 1; it != expr.list.end(); ++it)
+		{
+			bool cond;
+			if (!is_literal(*it) || !literal_conditional(*it, cond))
+				return;
+			if (cond == decided)
+			{
+				replace_with_literal(expr, variable::boolean(decided));
+				return;
+			}
+		}
+		replace_with_literal(expr, variable::boolean(!decided));
+		return;
+	}
+
+	for (auto it = expr.list.begin() + 1; it != expr.list.end(); ++it)
+	{
+		if (!is_literal(*it))
+			return;
+	}
+	if (traps_integer_division(expr, keyword))
+		return;
+
+	// NaN ȣ ҽ ű  Ƿ  ʽϴ.
+	bool folded = false;
+	try
+	{
+		variable val = eval_expr(expr);
+		if (val.type != var_type::number || !std::isnan(val.v_number))
+		{
+			replace_with_literal(expr, val);
+			folded = true;
+		}
+	}
+	catch (std::runtime_error&)
+	{
+		//    ܰ  ״ Ӵϴ.
+	}
+
+	if (!folded)
+	{
+		//   ϸ  handler feedback ϴ.
+		expr.handler = nullptr;
+		expr.feedback = 0;
+		expr.samples = 0;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void print_var(std::ostream& strm, variable var, int indent /* = 0 */)
+{
+	if (var.type == var_type::boolean)
+	{
+		conlib::setcolor_block scb(conlib::color::darkyellow);
+		strm << (var.v_boolean ? "true" : "false");
+	}
+	else if (var.type == var_type::number)
+	{
+		conlib::setcolor_block scb(conlib::color::darkyellow);
+		strm << var.v_number;
+	}
+	else if (var.type == var_type::undefined)
+	{
+		conlib::setcolor_block scb(conlib::color::darkgray);
+		strm << "(undefined)";
+	}
+	else
+	{
+		assert(var.type == var_type::object);
+
+		if (var.v_object == nullptr)
+		{
+			conlib::setcolor_block scb(conlib::color::darkgray);
+			strm << "(null)";
+		}
+		else if (var.v_object->type == object_type::string)
+		{
+			s_string* str = (s_string*)var.v_object;
+			strm << '"';
+			strm.write(str->ptr, str->size);
+			strm << '"';
+		}
+		else if (var.v_object->type == object_type::function)
+		{
+			conlib::setcolor_block scb(conlib::color::darkcyan);
+			s_function* fn = (s_function*)var.v_object;
+
+			strm << "(func (";
+			bool first = true;
+			for (const auto& p : fn->templ->parameters)
+			{
+				if (!first)
+					strm << ", ";
+				first = false;
+
+				strm << p->ptr;
+			}
+			if (!fn->templ->is_variadic)
+			{
+				strm << ") ";
+			}
+			else
+			{
+				if (first)
+					strm << "...) ";
+				else
+					strm << ", ...) ";
+			}
+
+			auto it = fn->obj()->vars.find(str_prototype);
+			bool ctor = false;
+			if (it != fn->obj()->vars.end())
+			{
+				if (it->second.type == var_type::object && it->second.v_object != nullptr)
+				{
+					conlib::setcolor_block scb(conlib::color::cyan);
+
+					s_object* proto = it->second.v_object;
+					if (proto->name->size != 0)
+					{
+						strm << "<" << proto->name->ptr << ">";
+					}
+					else
+					{
+						strm << "<";
+						conlib::setcolor_block scb(conlib::color::darkgray);
+						strm << "(unknown)";
+						scb.restore();
+						strm << ">";
+					}
+					ctor = true;
+				}
+			}
+			if (!ctor)
+			{
+				strm << "(..)";
+			}
+			strm << ")";
 		}
-		else
+		else if (var.v_object->type == object_type::array)
 		{
-			// getl
+			s_array* ar = (s_array*)var.v_object;
 
-			auto pit = find_local(expr.value);
-			if (pit)
+			if (ar->size() == 0)
 			{
-				return (*pit)->second;
+				strm << "[ ]";
 			}
 			else
 			{
-				return variable::undefined();
-			}
-		}
-	}
-	else
-	{
-		assert(expr.type == expr_type::list);
-
-		if (expr.list.empty())
-			return variable::undefined();
+				std::string str_indent((indent + 1) * 2, ' ');
+				bool first = true;
 
-		auto& front = expr.list.front();
+				for (std::size_t i = 0; i < ar->size(); ++i)
+				{
+					if (first)
+						strm << "[\n" << str_indent;
+					else
+						strm << ",\n" << str_indent;
+					first = false;
 
-		if (front.type == expr_type::atom)
-		{
-			auto it = list_keyword_map.find(front.value->ptr);
-			if (it != list_keyword_map.end())
-			{
-				return it->second(expr, context);
+					print_var(strm, ar->get(i), indent + 1);
+				}
+				strm << '\n' << std::string(indent * 2, ' ') << ']';
 			}
 		}
-
-		// function call
-
-		if (expr.list.size() <= 1)
-			throw invalid_func_call();
-
-		variable var = eval_expr(expr.list[0]);
-		s_function* f_fn = nullptr;
-
-		if (var.type == var_type::object && var.v_object != nullptr && expr.list[1].type == expr_type::atom)
+		else if (var.v_object->type == object_type::typed_array)
 		{
-			// try member function call
-			s_object* obj = var.v_object;
+			s_typed_array* ar = (s_typed_array*)var.v_object;
 
-			variable fn = variable::undefined();
-			do
 			{
-				auto it = obj->vars.find(expr.list[1].value);
-				if (it != obj->vars.end())
-				{
-					fn = it->second;
-					break;
-				}
-				obj = obj->proto;
-			} while (obj != nullptr);
+				conlib::setcolor_block scb(conlib::color::darkcyan);
+				strm << "<" << var.v_object->proto->name->ptr << "> ";
+			}
 
-			if (fn.type == var_type::object && fn.v_object->type == object_type::function)
+			if (ar->size == 0)
 			{
-				f_fn = (s_function*)fn.v_object;
+				strm << "[ ]";
 			}
-		}
-
-		if (f_fn == nullptr)
-		{
-			variable var2 = eval_expr(expr.list[1]);
-			if (var2.type == var_type::object && var2.v_object->type == object_type::function)
+			else
 			{
-				f_fn = (s_function*)var2.v_object;
+				std::string str_indent((indent + 1) * 2, ' ');
+
+				for (std::size_t i = 0; i < ar->size; ++i)
+				{
+					if (i == 0)
+						strm << "[\n" << str_indent;
+					else
+						strm << ",\n" << str_indent;
+
+					print_var(strm, load_element(ar, i), indent + 1);
+				}
+				strm << '\n' << std::string(indent * 2, ' ') << ']';
 			}
 		}
-
-		if (f_fn == nullptr)
+		else if (var.v_object->type == object_type::record_array)
 		{
-			throw list_evaluate_error();
-		}
+			s_record_array* records = (s_record_array*)var.v_object;
 
-		s_array* arguments = create_array();
-		for (auto it = expr.list.begin() + 2; it != expr.list.end(); ++it)
-		{
-			arguments->vector.push_back(eval_expr(*it));
-		}
+			{
+				conlib::setcolor_block scb(conlib::color::darkcyan);
+				strm << "<" << var.v_object->proto->name->ptr << "> ";
+			}
 
-		return call_function(f_fn, var, arguments);
-	}
-}
+			if (records->size == 0)
+			{
+				strm << "[ ]";
+			}
+			else
+			{
+				std::string str_indent((indent + 1) * 2, ' ');
 
-bool to_conditional(variable var)
-{
-	if ((var.type == var_type::boolean && var.v_boolean)
-		|| (var.type == var_type::object && var.v_object != nullptr))
-	{
-		return true;
-	}
-	else if ((var.type == var_type::boolean && !var.v_boolean)
-		|| (var.type == var_type::object && var.v_object == nullptr)
-		|| var.type == var_type::undefined)
-	{
-		return false;
-	}
-	else
-	{
-		throw invalid_conditional();
-	}
-}
+				for (std::size_t i = 0; i < records->size; ++i)
+				{
+					if (i == 0)
+						strm << "[\n" << str_indent;
+					else
+						strm << ",\n" << str_indent;
 
-std::int64_t to_integer(double n)
-{
-	double intpart;
-	if (std::modf(n, &intpart) != 0.0)
-		throw not_integer_error();
-	if (intpart > INT64_MAX)
-		throw not_integer_error();
-	return static_cast<std::int64_t>(intpart);
-}
+					print_var(strm, create_record(records, i)->var(), indent + 1);
+				}
+				strm << '\n' << std::string(indent * 2, ' ') << ']';
+			}
+		}
+		else if (var.v_object->type == object_type::map)
+		{
+			s_map* map = (s_map*)var.v_object;
 
-boost::optional<object_map::iterator> find_member(s_object* obj, s_string* name)
-{
-	do
-	{
-		auto it = obj->vars.find(name);
-		if (it != obj->vars.end())
-			return it;
+			{
+				conlib::setcolor_block scb(conlib::color::darkcyan);
+				strm << "<" << var.v_object->proto->name->ptr << "> ";
+			}
 
-		obj = obj->proto;
-	} while (obj != nullptr);
+			if (map->size == 0)
+			{
+				strm << "{ }";
+			}
+			else
+			{
+				std::string str_indent((indent + 1) * 2, ' ');
+				bool first = true;
 
-	return boost::optional<object_map::iterator>();
-}
+				map_for_each(map, [&](const map_slot& slot) {
+					if (first)
+						strm << "{\n" << str_indent;
+					else
+						strm << ",\n" << str_indent;
+					first = false;
 
-boost::optional<object_map::iterator> find_local(s_string* name)
-{
-	if (!stackframe.empty())
-	{
-		for (auto sit = stackframe.rbegin(); sit != stackframe.rend(); ++sit)
+					print_var(strm, slot.key, indent + 1);
+					strm << ": ";
+					print_var(strm, slot.value, indent + 1);
+				});
+				strm << '\n' << std::string(indent * 2, ' ') << '}';
+			}
+		}
+		else if (var.v_object->type == object_type::string_builder)
 		{
-			for (auto bit = sit->blocks.rbegin(); bit != sit->blocks.rend(); ++bit)
+			s_string_builder* builder = (s_string_builder*)var.v_object;
+
 			{
-				auto it = bit->find(name);
-				if (it != bit->end())
-				{
-					return it;
-				}
+				conlib::setcolor_block scb(conlib::color::darkcyan);
+				strm << "<" << var.v_object->proto->name->ptr << "> ";
 			}
+			strm << '"';
+			strm.write(builder->buffer.data(), builder->buffer.size());
+			strm << '"';
 		}
-	}
-
-	return find_member(global_object, name);
-}
-
-variable call_function(s_function* fn, variable new_this, s_array* arguments)
-{
-	if (fn->parameters.size() < arguments->vector.size() && !fn->is_variadic)
-		throw invalid_arg_error();
-
-	frame_entry frame;
-	frame.arguments = arguments;
-
-	object_map locals;
-	for (std::size_t i = 0; i < fn->parameters.size(); ++i)
-	{
-		variable val;
-		if (i < frame.arguments->vector.size())
-			val = frame.arguments->vector[i];
 		else
-			val = variable::undefined();
-
-		locals.insert({ fn->parameters[i], val });
-	}
-	frame.blocks.push_back(std::move(locals));
-	frame.this_var = new_this;
-
-	stackframe.push_back(frame);
-	this_var = new_this;
-
-	variable ret;
-	if (!fn->is_native)
-	{
-		ret = eval_expr(*fn->expr);
-	}
-	else
-	{
-		ret = fn->native_fn(this_var, arguments);
-	}
-
-	stackframe.pop_back();
-	if (!stackframe.empty())
-		this_var = stackframe.front().this_var;
-	else
-		this_var = variable::object(global_object);
-
-	return ret;
-}
-
-// atom keyword handler
-
-variable eval_expr_keyword_global(eval_context& context)
-{
-	return variable::object(global_object);
-}
-
-variable eval_expr_keyword_this(eval_context& context)
-{
-	return this_var;
-}
-
-variable eval_expr_keyword_undefined(eval_context& context)
-{
-	return variable::undefined();
-}
+		{
+			assert(var.v_object->type == object_type::object || var.v_object->type == object_type::record);
 
-variable eval_expr_keyword_null(eval_context& context)
-{
-	return variable::object(nullptr);
-}
+			if (var.v_object->proto == nullptr)
+			{
+				conlib::setcolor_block scb(conlib::color::darkcyan);
+				strm << "<";
+				conlib::setcolor(conlib::color::darkgray);
+				strm << "(raw)";
+				scb.restore();
+				strm << "> ";
+			}
+			else if (var.v_object->proto != p_Object)
+			{
+				conlib::setcolor_block scb(conlib::color::darkcyan);
+				s_string* name = var.v_object->proto->name;
+				strm << "<";
+				if (name->size != 0)
+				{
+					strm << var.v_object->proto->name->ptr;
+				}
+				else
+				{
+					conlib::setcolor_block scb(conlib::color::darkgray);
+					strm << "(unknown)";
+				}
+				strm << "> ";
+			}
 
-variable eval_expr_keyword_true(eval_context & context)
-{
-	return variable::boolean(true);
-}
+			if (var.v_object->type == object_type::record)
+			{
+				// record field column Ƿ field  մϴ.
+				s_record* rec = (s_record*)var.v_object;
+				std::string str_indent((indent + 1) * 2, ' ');
+				bool first = true;
 
-variable eval_expr_keyword_false(eval_context & context)
-{
-	return variable::boolean(false);
-}
+				for (s_string* field : rec->owner->fields)
+				{
+					if (first)
+						strm << "{\n" << str_indent;
+					else
+						strm << ",\n" << str_indent;
+					first = false;
 
-variable eval_expr_keyword_prev(eval_context& context)
-{
-	return prev_var;
-}
+					strm << field->ptr << ": ";
+					print_var(strm, get_member(var.v_object, field), indent + 1);
+				}
+				strm << '\n' << std::string(indent * 2, ' ') << '}';
+			}
+			else if (var.v_object->vars.empty())
+			{
+				strm << "{ }";
+			}
+			else
+			{
+				std::string str_indent((indent + 1) * 2, ' ');
+				bool first = true;
 
-variable eval_expr_keyword_arguments(eval_context& context)
-{
-	if (!stackframe.empty())
-		return variable::object(stackframe.front().arguments->obj());
-	else
-		return variable::undefined();
-}
+				for (const auto& pr : var.v_object->vars)
+				{
+					if (first)
+						strm << "{\n" << str_indent;
+					else
+						strm << ",\n" << str_indent;
+					first = false;
 
-variable eval_expr_keyword_dotdotdot_(eval_context& context)
-{
-	throw invalid_keyword_atom();
+					strm << pr.first->ptr << ": ";
+					print_var(strm, pr.second, indent + 1);
+				}
+				strm << '\n' << std::string(indent * 2, ' ') << '}';
+			}
+		}
+	}
 }
 
-// list keyword handler
-
-variable eval_expr_keyword_func(const expression& expr, eval_context& context)
+void dump_expr(const expression& expr, int indent /* = 0 */)
 {
-	s_string* name = nullptr;
-	const expression* params;
-	const expression* body;
-	bool ctor;
+	std::string str_indent(indent * 2, ' ');
 
-	if (expr.list.size() == 3)
+	std::cout << str_indent;
+
+	if (expr.type == expr_type::atom)
 	{
-		params = &expr.list[1];
-		body = &expr.list[2];
-		ctor = false;
+		std::cout << "[atom] " << expr.value->ptr << "\n";
 	}
-	else if (expr.list.size() == 4)
+	else if (expr.type == expr_type::string)
 	{
-		if (expr.list[1].type != expr_type::atom)
-			throw invalid_keyword_list();
-		name = expr.list[1].value;
-		params = &expr.list[2];
-		body = &expr.list[3];
-		ctor = true;
+		std::cout << "[string] " << expr.value->ptr << "\n";
+	}
+	else if (expr.type == expr_type::number)
+	{
+		std::cout << "[number] " << expr.number << "\n";
 	}
 	else
 	{
-		throw invalid_keyword_list();
+		if (expr.list.empty())
+		{
+			std::cout << "( )\n";
+		}
+		else
+		{
+			std::cout << "(\n";
+			for (const auto& sub : expr.list)
+			{
+				dump_expr(sub, indent + 1);
+			}
+			std::cout << str_indent << ")\n";
+		}
 	}
+}
 
-	if (params->type != expr_type::list)
-		throw invalid_keyword_list();
 
-	gc_vector<s_string*> par;
-	bool is_variadic = false;
-	for (const auto& p : params->list)
-	{
-		if (is_variadic)
-			throw invalid_keyword_list();
+std::string expr_to_string(const expression& expr, std::size_t limit /* = 60 */)
+{
+	std::string ret;
 
-		if (p.type != expr_type::atom)
-			throw invalid_keyword_list();
+	std::function<void(const expression&)> append = [&](const expression& e) {
+		if (ret.size() > limit)
+			return;
 
-		if (strcmp(p.value->ptr, "...") == 0)
+		if (e.type == expr_type::atom)
 		{
-			is_variadic = true;
-			continue;
+			ret += e.value->ptr;
 		}
-		else if (is_keyword(p.value->ptr))
+		else if (e.type == expr_type::string)
 		{
-			throw invalid_atom_error();
+			ret += '"';
+			ret += e.value->ptr;
+			ret += '"';
 		}
-
-		par.emplace_back(p.value);
-	}
-
-	s_function* fn = create_function(par, *body, is_variadic);
-	if (ctor)
-	{
-		s_object* prototype = create_object();
-		prototype->name = name;
-		fn->obj()->vars[str_prototype] = prototype->var();
-
-		auto pit = find_local(name);
-		if (pit)
+		else if (e.type == expr_type::number)
 		{
-			(*pit)->second = fn->var();
+			std::ostringstream strm;
+			strm << e.number;
+			ret += strm.str();
 		}
 		else
 		{
-			object_map* mp;
-
-			if (stackframe.empty())
-				mp = &global_object->vars;
-			else
-				mp = &stackframe.front().blocks.front();
-
-			mp->insert({ name, fn->var() });
+			ret += '(';
+			bool first = true;
+			for (const auto& sub : e.list)
+			{
+				if (!first)
+					ret += ' ';
+				first = false;
+				append(sub);
+			}
+			ret += ')';
 		}
+	};
+	append(expr);
 
+	if (ret.size() > limit)
+	{
+		ret.resize(limit);
+		ret += "...";
 	}
-
-	return variable::object(fn->obj());
+	return ret;
 }
 
-variable eval_expr_keyword_new(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() < 2)
-		throw invalid_keyword_list();
-
-	variable v_ctor = eval_expr(expr.list[1]);
-	if (v_ctor.type != var_type::object)
-		throw not_object_error();
-	if (v_ctor.v_object->type != object_type::function)
-		throw not_function_error();
-
-	s_function* ctor = (s_function*)v_ctor.v_object;
+////////////////////////////////////////////////////////////////////////////////
 
-	s_array* arguments = create_array();
-	for (auto it = expr.list.begin() + 2; it != expr.list.end(); ++it)
+namespace
+{
+	std::size_t shallow_size(s_object* obj)
 	{
-		arguments->vector.push_back(eval_expr(*it));
-	}
+		std::size_t size = obj->vars.heap_size();
 
-	s_object* obj = create_object();
-	auto pit = find_member(ctor->obj(), str_prototype);
-	if (pit)
-	{
-		if ((*pit)->second.type != var_type::object)
-			throw not_object_error();
-		obj->proto = (*pit)->second.v_object;
+		switch (obj->type)
+		{
+		case object_type::string:
+			// slice ڴ base  ֽϴ.
+			if (((s_string*)obj)->base != nullptr)
+				return size + sizeof(s_string);
+			return size + sizeof(s_string) + ((s_string*)obj)->size + 1;
+		case object_type::function:
+			return size + sizeof(s_function);
+		case object_type::array:
+		{
+			s_array* arr = (s_array*)obj;
+			return size + sizeof(s_array) + arr->vector.capacity() * sizeof(variable)
+				+ arr->ints.capacity() * sizeof(std::int32_t) + arr->doubles.capacity() * sizeof(double);
+		}
+		case object_type::typed_array:
+			return size + sizeof(s_typed_array) + ((s_typed_array*)obj)->size * element_size(((s_typed_array*)obj)->element);
+		case object_type::record_array:
+			return size + sizeof(s_record_array) + ((s_record_array*)obj)->fields.capacity() * sizeof(s_string*)
+				+ ((s_record_array*)obj)->columns.capacity() * sizeof(s_array*);
+		case object_type::record:
+			return size + sizeof(s_record);
+		case object_type::map:
+			return size + sizeof(s_map) + ((s_map*)obj)->ctrl.capacity() + ((s_map*)obj)->slots.capacity() * sizeof(map_slot);
+		case object_type::string_builder:
+			return size + sizeof(s_string_builder) + ((s_string_builder*)obj)->buffer.capacity();
+		default:
+			return size + sizeof(s_object);
+		}
 	}
 
-	call_function(ctor, variable::object(obj), arguments);
-
-	return variable::object(obj);
-}
-
-variable eval_expr_keyword_array(const expression & expr, eval_context & context)
-{
-	s_array* ret = create_array();
-	for (auto it = expr.list.begin() + 1; it != expr.list.end(); ++it)
+	template <typename Fn>
+	void for_each_child(s_object* obj, Fn fn)
 	{
-		ret->vector.push_back(eval_expr(*it));
-	}
-
-	return variable::object(ret->obj());
-}
-
-variable eval_expr_keyword_getf(const expression& expr, eval_context& context)
-{
-	s_object* obj;
-	s_string* var_name;
+		if (obj->proto != nullptr)
+			fn(obj->proto);
+		if (obj->name != nullptr)
+			fn(obj->name->obj());
 
-	if (expr.list.size() == 3)
-	{
-		variable tmp = eval_expr(expr.list[1]);
-		if (tmp.type != var_type::object)
-			throw not_object_error();
-		obj = tmp.v_object;
+		for (const auto& pr : obj->vars)
+		{
+			fn(pr.first->obj());
+			if (pr.second.type == var_type::object && pr.second.v_object != nullptr)
+				fn(pr.second.v_object);
+		}
 
-		if (expr.list[2].type != expr_type::atom)
-			throw invalid_keyword_list();
-		var_name = expr.list[2].value;
+		if (obj->type == object_type::function)
+		{
+			for (s_string* p : ((s_function*)obj)->templ->parameters)
+				fn(p->obj());
+		}
+		else if (obj->type == object_type::array)
+		{
+			// packed 迭 ׸ object Ű ʽϴ.
+			for (variable var : ((s_array*)obj)->vector)
+			{
+				if (var.type == var_type::object && var.v_object != nullptr)
+					fn(var.v_object);
+			}
+		}
+		else if (obj->type == object_type::record_array)
+		{
+			s_record_array* records = (s_record_array*)obj;
+			fn(records->record_proto);
+			for (s_string* field : records->fields)
+				fn(field->obj());
+			for (s_array* column : records->columns)
+				fn(column->obj());
+		}
+		else if (obj->type == object_type::record)
+		{
+			fn(((s_record*)obj)->owner->obj());
+		}
+		else if (obj->type == object_type::map)
+		{
+			map_for_each((s_map*)obj, [&fn](const map_slot& slot) {
+				if (slot.key.type == var_type::object && slot.key.v_object != nullptr)
+					fn(slot.key.v_object);
+				if (slot.value.type == var_type::object && slot.value.v_object != nullptr)
+					fn(slot.value.v_object);
+			});
+		}
+		else if (obj->type == object_type::string)
+		{
+			if (((s_string*)obj)->base != nullptr)
+				fn(((s_string*)obj)->base->obj());
+		}
+		else if (obj->type == object_type::string_builder)
+		{
+			if (((s_string_builder*)obj)->flat != nullptr)
+				fn(((s_string_builder*)obj)->flat->obj());
+		}
 	}
-	else if (expr.list.size() == 2)
-	{
-		if (this_var.type != var_type::object)
-			throw not_object_error();
-		obj = this_var.v_object;
 
-		if (expr.list[1].type != expr_type::atom)
-			throw invalid_keyword_list();
-		var_name = expr.list[1].value;
-	}
-	else
+	const char* type_name(object_type type)
 	{
-		throw invalid_keyword_list();
+		switch (type)
+		{
+		case object_type::string: return "string";
+		case object_type::function: return "function";
+		case object_type::array: return "array";
+		case object_type::typed_array: return "typed array";
+		case object_type::record_array: return "record array";
+		case object_type::record: return "record";
+		case object_type::map: return "map";
+		case object_type::string_builder: return "str builder";
+		default: return "object";
+		}
 	}
 
-	if (obj == nullptr)
-		throw null_reference_error();
-
-	auto pit = find_member(obj, var_name);
-	if (pit)
+	std::string proto_name(s_object* obj)
 	{
-		return (*pit)->second;
+		if (obj->proto == nullptr)
+			return "(raw)";
+		else if (obj->proto->name == nullptr || obj->proto->name->size == 0)
+			return "(unknown)";
+		else
+			return obj->proto->name->ptr;
 	}
-	else
+
+	std::string json_escape(const std::string& str)
 	{
-		return variable::undefined();
+		std::string ret;
+		for (char ch : str)
+		{
+			if (ch == '"' || ch == '\\')
+			{
+				ret.push_back('\\');
+				ret.push_back(ch);
+			}
+			else if ((unsigned char)ch < 0x20)
+			{
+				char buf[8];
+				std::snprintf(buf, sizeof(buf), "\\u%04x", ch);
+				ret += buf;
+			}
+			else
+			{
+				ret.push_back(ch);
+			}
+		}
+		return ret;
 	}
 }
 
-variable eval_expr_keyword_setf(const expression& expr, eval_context& context)
+void heap_snapshot(std::ostream& report, std::ostream* json)
 {
-	s_object* obj;
-	s_string* var_name;
-	const expression* expr_val;
-
-	if (expr.list.size() == 4)
-	{
-		variable tmp = eval_expr(expr.list[1]);
-		if (tmp.type != var_type::object)
-			throw not_object_error();
-		obj = tmp.v_object;
+	const std::size_t top_count = 10;
+
+	// 0 node  root Ű  rootԴϴ.
+	std::vector<s_object*> nodes { nullptr };
+	std::unordered_map<s_object*, std::size_t> index;
+	std::vector<std::vector<std::size_t>> edges(1);
+
+	auto visit = [&](s_object* obj) -> std::size_t {
+		auto it = index.find(obj);
+		if (it != index.end())
+			return it->second;
+
+		std::size_t id = nodes.size();
+		index.insert({ obj, id });
+		nodes.push_back(obj);
+		edges.emplace_back();
+		return id;
+	};
+	auto add_root = [&](variable var) {
+		if (var.type == var_type::object && var.v_object != nullptr)
+		{
+			std::size_t id = visit(var.v_object);
+			edges[0].push_back(id);
+		}
+	};
 
-		if (expr.list[2].type != expr_type::atom)
-			throw invalid_keyword_list();
-		var_name = expr.list[2].value;
+	add_root(variable::object(global_object));
+	add_root(this_var);
+	add_root(prev_var);
+	for (s_object* obj : { p_Object, p_Function, p_String, p_Array, f_Object, f_Function, f_String, f_Array })
+		add_root(variable::object(obj));
 
-		expr_val = &expr.list[3];
-	}
-	else if (expr.list.size() == 3)
+	for (const auto& frame : stackframe)
 	{
-		if (this_var.type != var_type::object)
-			throw not_object_error();
-		obj = this_var.v_object;
-
-		if (expr.list[1].type != expr_type::atom)
-			throw invalid_keyword_list();
-		var_name = expr.list[1].value;
-
-		expr_val = &expr.list[2];
+		add_root(frame.arguments->var());
+		add_root(frame.this_var);
+		for (const auto& block : frame.blocks)
+		{
+			for (const auto& pr : block)
+			{
+				add_root(pr.first->var());
+				add_root(pr.second);
+			}
+		}
 	}
-	else
+
+	// visit() nodes edges øǷ index ȸմϴ.
+	for (std::size_t i = 1; i < nodes.size(); ++i)
 	{
-		throw invalid_keyword_list();
+		std::vector<std::size_t> children;
+		for_each_child(nodes[i], [&](s_object* child) {
+			children.push_back(visit(child));
+		});
+		edges[i] = std::move(children);
 	}
 
-	if (obj == nullptr)
-		throw null_reference_error();
-
-	variable val = eval_expr(*expr_val);
+	const std::size_t count = nodes.size();
+	const std::size_t undef = static_cast<std::size_t>(-1);
 
-	auto pit = find_member(obj, var_name);
-	if (pit)
+	//  root ϴ DFS postorder ȣ űϴ.
+	std::vector<std::size_t> postorder;
+	std::vector<std::size_t> po_number(count, undef);
 	{
-		(*pit)->second = val;
+		std::vector<bool> seen(count, false);
+		std::vector<std::pair<std::size_t, std::size_t>> dfs { { 0, 0 } };
+		seen[0] = true;
+
+		while (!dfs.empty())
+		{
+			auto& top = dfs.back();
+			if (top.second < edges[top.first].size())
+			{
+				std::size_t next = edges[top.first][top.second++];
+				if (!seen[next])
+				{
+					seen[next] = true;
+					dfs.push_back({ next, 0 });
+				}
+			}
+			else
+			{
+				po_number[top.first] = postorder.size();
+				postorder.push_back(top.first);
+				dfs.pop_back();
+			}
+		}
 	}
-	else
+
+	std::vector<std::vector<std::size_t>> preds(count);
+	for (std::size_t i = 0; i < count; ++i)
 	{
-		obj->vars.insert({ var_name, val });
+		for (std::size_t child : edges[i])
+			preds[child].push_back(i);
 	}
 
-	return val;
-}
+	// Cooper, Harvey, Kennedy ݺ ˰ immediate dominator մϴ.
+	std::vector<std::size_t> idom(count, undef);
+	idom[0] = 0;
 
-variable eval_expr_keyword_getl(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() != 2)
-		throw invalid_keyword_list();
+	auto intersect = [&](std::size_t a, std::size_t b) {
+		while (a != b)
+		{
+			while (po_number[a] < po_number[b])
+				a = idom[a];
+			while (po_number[b] < po_number[a])
+				b = idom[b];
+		}
+		return a;
+	};
 
-	s_string* var_name;
+	bool changed = true;
+	while (changed)
+	{
+		changed = false;
+		for (auto it = std::next(postorder.rbegin()); it != postorder.rend(); ++it)
+		{
+			std::size_t n = *it;
+			std::size_t new_idom = undef;
 
-	if (expr.list[1].type != expr_type::atom)
-		throw invalid_keyword_list();
-	var_name = expr.list[1].value;
+			for (std::size_t p : preds[n])
+			{
+				if (idom[p] == undef)
+					continue;
+				new_idom = (new_idom == undef) ? p : intersect(p, new_idom);
+			}
 
-	auto pit = find_local(var_name);
-	if (pit)
-	{
-		return (*pit)->second;
+			if (idom[n] != new_idom)
+			{
+				idom[n] = new_idom;
+				changed = true;
+			}
+		}
 	}
-	else
+
+	std::vector<std::size_t> shallow(count, 0);
+	std::vector<std::size_t> retained(count, 0);
+	for (std::size_t i = 1; i < count; ++i)
+		shallow[i] = retained[i] = shallow_size(nodes[i]);
+
+	// idom ׻ ڽĺ postorder ȣ ũǷ postorder  ϸ ˴ϴ.
+	for (std::size_t n : postorder)
 	{
-		return variable::undefined();
+		if (n != 0)
+			retained[idom[n]] += retained[n];
 	}
-}
 
-variable eval_expr_keyword_setl(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() != 3)
-		throw invalid_keyword_list();
+	struct group_info
+	{
+		std::string type;
+		std::string proto;
+		std::size_t count = 0;
+		std::size_t shallow = 0;
+		std::size_t retained = 0;
+	};
 
-	s_string* var_name;
+	// dominator tree  鼭,  group object  ʴ object group retained size մϴ.
+	std::vector<std::vector<std::size_t>> dom_children(count);
+	for (std::size_t i = 1; i < count; ++i)
+		dom_children[idom[i]].push_back(i);
 
-	if (expr.list[1].type != expr_type::atom)
-		throw invalid_keyword_list();
-	var_name = expr.list[1].value;
+	std::vector<std::size_t> group_of(count, 0);
+	std::vector<group_info> groups;
+	std::vector<group_info> type_groups(9);
+	{
+		std::unordered_map<std::string, std::size_t> group_index;
+		for (std::size_t i = 1; i < count; ++i)
+		{
+			std::string type = type_name(nodes[i]->type);
+			std::string proto = proto_name(nodes[i]);
 
-	variable val = eval_expr(expr.list[2]);
+			auto it = group_index.find(type + ' ' + proto);
+			if (it == group_index.end())
+			{
+				it = group_index.insert({ type + ' ' + proto, groups.size() }).first;
+				groups.emplace_back();
+				groups.back().type = type;
+				groups.back().proto = proto;
+			}
+			group_of[i] = it->second;
+		}
+	}
 
-	auto pit = find_local(var_name);
-	if (pit)
 	{
-		(*pit)->second = val;
+		std::vector<std::size_t> active(groups.size(), 0);
+		std::vector<std::size_t> active_type(type_groups.size(), 0);
+		std::vector<std::pair<std::size_t, bool>> dfs { { 0, false } };
+
+		while (!dfs.empty())
+		{
+			auto top = dfs.back();
+			dfs.pop_back();
+			std::size_t n = top.first;
+			std::size_t g = group_of[n];
+			std::size_t t = static_cast<std::size_t>(nodes[n] ? nodes[n]->type : object_type::object);
+
+			if (top.second)
+			{
+				--active[g];
+				--active_type[t];
+				continue;
+			}
+
+			if (n != 0)
+			{
+				groups[g].count++;
+				groups[g].shallow += shallow[n];
+				if (active[g] == 0)
+					groups[g].retained += retained[n];
+
+				type_groups[t].type = type_name(nodes[n]->type);
+				type_groups[t].count++;
+				type_groups[t].shallow += shallow[n];
+				if (active_type[t] == 0)
+					type_groups[t].retained += retained[n];
+
+				++active[g];
+				++active_type[t];
+				dfs.push_back({ n, true });
+			}
+
+			for (std::size_t child : dom_children[n])
+				dfs.push_back({ child, false });
+		}
 	}
-	else
-	{
-		object_map* mp;
+	type_groups.erase(std::remove_if(type_groups.begin(), type_groups.end(),
+		[](const group_info& t) { return t.count == 0; }), type_groups.end());
 
-		if (stackframe.empty())
-			mp = &global_object->vars;
-		else
-			mp = &stackframe.front().blocks.front();
+	auto by_retained = [](const group_info& a, const group_info& b) { return a.retained > b.retained; };
+	std::sort(groups.begin(), groups.end(), by_retained);
+	std::sort(type_groups.begin(), type_groups.end(), by_retained);
 
-		mp->insert({ var_name, val });
+	std::vector<std::size_t> arrays, objects;
+	for (std::size_t i = 1; i < count; ++i)
+	{
+		if (nodes[i]->type == object_type::array || nodes[i]->type == object_type::typed_array
+			|| nodes[i]->type == object_type::record_array)
+			arrays.push_back(i);
+		else if (nodes[i]->type == object_type::object || nodes[i]->type == object_type::map)
+			objects.push_back(i);
 	}
+	auto take_largest = [&](std::vector<std::size_t>& list) {
+		auto by_size = [&](std::size_t a, std::size_t b) { return retained[a] > retained[b]; };
+		if (list.size() > top_count)
+		{
+			std::partial_sort(list.begin(), list.begin() + top_count, list.end(), by_size);
+			list.resize(top_count);
+		}
+		else
+		{
+			std::sort(list.begin(), list.end(), by_size);
+		}
+	};
+	take_largest(arrays);
+	take_largest(objects);
+
+	auto length_of = [&](std::size_t n) {
+		if (nodes[n]->type == object_type::array)
+			return ((s_array*)nodes[n])->size();
+		else if (nodes[n]->type == object_type::typed_array)
+			return ((s_typed_array*)nodes[n])->size;
+		else if (nodes[n]->type == object_type::record_array)
+			return ((s_record_array*)nodes[n])->size;
+		else if (nodes[n]->type == object_type::map)
+			return ((s_map*)nodes[n])->size;
+		else
+			return nodes[n]->vars.size();
+	};
 
-	return val;
-}
+	// text report
 
-variable eval_expr_keyword_geti(const expression & expr, eval_context & context)
-{
-	if (expr.list.size() == 3)
-		throw invalid_keyword_list();
+	report << "heap snapshot: " << (count - 1) << " objects, "
+		<< retained[0] << " bytes reachable\n";
 
-	s_object* obj;
-	s_string* var_name;
+	auto print_groups = [&](const char* title, const std::vector<group_info>& list, bool with_proto) {
+		report << "\n[" << title << "]\n";
+		report << "  " << std::left << std::setw(14) << "type";
+		if (with_proto)
+			report << std::setw(20) << "prototype";
+		report << std::right << std::setw(10) << "count"
+			<< std::setw(14) << "shallow" << std::setw(14) << "retained" << "\n";
 
-	variable tmp = eval_expr(expr.list[1]);
-	if (tmp.type != var_type::object)
-		throw not_object_error();
-	if (tmp.v_object == nullptr)
-		throw null_reference_error();
-	obj = tmp.v_object;
+		for (const auto& g : list)
+		{
+			report << "  " << std::left << std::setw(14) << g.type;
+			if (with_proto)
+				report << std::setw(20) << g.proto;
+			report << std::right << std::setw(10) << g.count
+				<< std::setw(14) << g.shallow << std::setw(14) << g.retained << "\n";
+		}
+	};
+	print_groups("by type", type_groups, false);
+	print_groups("by prototype", groups, true);
 
-	tmp = eval_expr(expr.list[2]);
-	if (tmp.type != var_type::object)
-		throw not_string_error();
-	if (tmp.v_object == nullptr)
-		throw not_string_error();
-	if (tmp.v_object->type != object_type::string)
-		throw not_string_error();
-	var_name = (s_string*)tmp.v_object;
+	auto print_largest = [&](const char* title, const char* length_name, const std::vector<std::size_t>& list) {
+		report << "\n[" << title << "]\n";
+		for (std::size_t n : list)
+		{
+			report << "  " << static_cast<const void*>(nodes[n])
+				<< " <" << proto_name(nodes[n]) << "> "
+				<< length_name << "=" << length_of(n)
+				<< " shallow=" << shallow[n]
+				<< " retained=" << retained[n] << "\n";
+		}
+	};
+	print_largest("largest arrays", "length", arrays);
+	print_largest("largest objects", "fields", objects);
+	report.flush();
 
-	auto pit = find_member(obj, var_name);
-	if (pit)
-	{
-		return (*pit)->second;
-	}
-	else
+	// machine-readable report
+
+	if (json != nullptr)
 	{
-		return variable::undefined();
+		std::ostream& out = *json;
+
+		out << "{\n  \"objects\": " << (count - 1)
+			<< ",\n  \"reachable\": " << retained[0]
+			<< ",\n  \"groups\": [";
+
+		bool first = true;
+		for (const auto& g : groups)
+		{
+			out << (first ? "\n" : ",\n") << "    { \"type\": \"" << g.type
+				<< "\", \"prototype\": \"" << json_escape(g.proto)
+				<< "\", \"count\": " << g.count
+				<< ", \"shallow\": " << g.shallow
+				<< ", \"retained\": " << g.retained << " }";
+			first = false;
+		}
+		out << "\n  ],\n  \"largest\": [";
+
+		first = true;
+		for (const auto* list : { &arrays, &objects })
+		{
+			for (std::size_t n : *list)
+			{
+				out << (first ? "\n" : ",\n") << "    { \"address\": \"" << static_cast<const void*>(nodes[n])
+					<< "\", \"type\": \"" << type_name(nodes[n]->type)
+					<< "\", \"prototype\": \"" << json_escape(proto_name(nodes[n]))
+					<< "\", \"length\": " << length_of(n)
+					<< ", \"shallow\": " << shallow[n]
+					<< ", \"retained\": " << retained[n] << " }";
+				first = false;
+			}
+		}
+		out << "\n  ]\n}\n";
 	}
 }
 
-variable eval_expr_keyword_seti(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() == 4)
-		throw invalid_keyword_list();
-
-	s_object* obj;
-	s_string* var_name;
+////////////////////////////////////////////////////////////////////////////////
 
-	variable tmp = eval_expr(expr.list[1]);
-	if (tmp.type != var_type::object)
-		throw not_object_error();
-	if (tmp.v_object == nullptr)
-		throw null_reference_error();
-	obj = tmp.v_object;
+namespace
+{
+	struct alloc_record
+	{
+		// expression Ǿ ּҰ  ʵ root  Ӵϴ.
+		std::shared_ptr<expression> root;
+		std::string text;
+		std::size_t count[4] = { };
+		std::size_t bytes = 0;
 
-	tmp = eval_expr(expr.list[2]);
-	if (tmp.type != var_type::object)
-		throw not_string_error();
-	if (tmp.v_object == nullptr)
-		throw not_string_error();
-	if (tmp.v_object->type != object_type::string)
-		throw not_string_error();
-	var_name = (s_string*)tmp.v_object;
+		std::size_t total() const
+		{
+			return count[0] + count[1] + count[2] + count[3];
+		}
+	};
 
-	variable val = eval_expr(expr.list[3]);
+	std::unordered_map<const expression*, alloc_record> alloc_sites;
+	std::unordered_map<const expression*, alloc_record> alloc_functions;
 
-	auto pit = find_member(obj, var_name);
-	if (pit)
-	{
-		(*pit)->second = val;
-	}
-	else
+	//   native ƴ Լ ãϴ. ٸ ֻ Ҵ Դϴ.
+	s_function* enclosing_function()
 	{
-		obj->vars[var_name] = val;
+		for (auto it = stackframe.rbegin(); it != stackframe.rend(); ++it)
+		{
+			if (!it->function->templ->is_native)
+				return it->function;
+		}
+		return nullptr;
 	}
 
-	return val;
-}
-
-variable eval_expr_keyword_do(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() <= 1)
-		throw invalid_keyword_list();
+	std::string function_to_string(s_function* fn)
+	{
+		auto it = fn->obj()->vars.find(str_prototype);
+		if (it != fn->obj()->vars.end() && it->second.type == var_type::object && it->second.v_object != nullptr)
+		{
+			s_string* name = it->second.v_object->name;
+			if (name != nullptr && name->size != 0)
+				return std::string("<") + name->ptr + ">";
+		}
 
-	variable ret;
+		std::string ret = "(func (";
+		bool first = true;
+		for (s_string* p : fn->templ->parameters)
+		{
+			if (!first)
+				ret += ' ';
+			first = false;
+			ret += p->ptr;
+		}
+		if (fn->templ->is_variadic)
+			ret += first ? "..." : " ...";
+		ret += ") ";
+		ret += expr_to_string(*fn->templ->expr, 40);
+		ret += ')';
+		return ret;
+	}
 
-	for (auto it = std::next(expr.list.cbegin()); it != expr.list.cend(); ++it)
+	void add_alloc(alloc_record& rec, object_type type, std::size_t bytes)
 	{
-		ret = eval_expr(*it);
-		prev_var = ret;
+		++rec.count[static_cast<int>(type)];
+		rec.bytes += bytes;
 	}
-
-	prev_var = variable::undefined();
-	return ret;
 }
 
-variable eval_expr_keyword_if(const expression& expr, eval_context& context)
+void record_alloc(object_type type, std::size_t bytes)
 {
-	if (expr.list.size() != 4)
-		throw invalid_keyword_list();
-
-	bool cond = to_conditional(eval_expr(expr.list[1]));
-	if (cond)
+	auto sit = alloc_sites.find(alloc_site);
+	if (sit == alloc_sites.end())
 	{
-		return eval_expr(expr.list[2]);
+		alloc_record rec;
+		if (alloc_site != nullptr)
+		{
+			rec.root = alloc_site->root.lock();
+			rec.text = expr_to_string(*alloc_site);
+		}
+		else
+		{
+			rec.text = "(runtime)";
+		}
+		sit = alloc_sites.insert({ alloc_site, std::move(rec) }).first;
 	}
-	else
+	add_alloc(sit->second, type, bytes);
+
+	s_function* fn = enclosing_function();
+	const expression* fn_expr = (fn != nullptr) ? fn->templ->expr : nullptr;
+
+	auto fit = alloc_functions.find(fn_expr);
+	if (fit == alloc_functions.end())
 	{
-		return eval_expr(expr.list[3]);
+		alloc_record rec;
+		if (fn != nullptr)
+		{
+			rec.root = fn->expr_root;
+			rec.text = function_to_string(fn);
+		}
+		else
+		{
+			rec.text = "(toplevel)";
+		}
+		fit = alloc_functions.insert({ fn_expr, std::move(rec) }).first;
 	}
+	add_alloc(fit->second, type, bytes);
 }
 
-variable eval_expr_keyword_while(const expression& expr, eval_context& context)
+void dump_alloc_profile(std::ostream& strm)
 {
-	if (expr.list.size() != 3)
-		throw invalid_keyword_list();
+	const std::size_t top_count = 20;
 
-	variable ret = variable::undefined();
+	if (alloc_sites.empty())
+		return;
+
+	auto print_table = [&](const char* title, const std::unordered_map<const expression*, alloc_record>& records) {
+		std::vector<const alloc_record*> list;
+		for (const auto& pr : records)
+			list.push_back(&pr.second);
+
+		std::sort(list.begin(), list.end(), [](const alloc_record* a, const alloc_record* b) {
+			return a->bytes > b->bytes || (a->bytes == b->bytes && a->total() > b->total());
+		});
+		if (list.size() > top_count)
+			list.resize(top_count);
+
+		strm << "\n[" << title << "]\n";
+		strm << std::right << std::setw(10) << "count" << std::setw(12) << "bytes"
+			<< std::setw(8) << "object" << std::setw(8) << "string"
+			<< std::setw(8) << "func" << std::setw(8) << "array" << "  site\n";
+
+		for (const alloc_record* rec : list)
+		{
+			strm << std::setw(10) << rec->total() << std::setw(12) << rec->bytes;
+			for (std::size_t c : rec->count)
+				strm << std::setw(8) << c;
+			strm << "  " << rec->text << "\n";
+		}
+	};
+
+	print_table("allocations by expression", alloc_sites);
+	print_table("allocations by function", alloc_functions);
+	strm.flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
-	while (to_conditional(eval_expr(expr.list[1])))
+namespace
+{
+	void log_tier_transition(s_function* fn, int from, int to, const char* note = nullptr)
 	{
-		ret = eval_expr(expr.list[2]);
-		prev_var = ret;
-	}
+		if (!tier_log)
+			return;
 
-	prev_var = variable::undefined();
-	return ret;
+		const function_template* templ = fn->templ;
+		conlib::setcolor_block scb(conlib::color::darkgray);
+		std::cout << "[tier] " << function_to_string(fn) << " " << from << " -> " << to
+			<< " (calls " << templ->call_count << ", loops " << templ->backedge_count;
+		if (note != nullptr)
+			std::cout << ", " << note;
+		std::cout << ")" << std::endl;
+	}
 }
 
-variable eval_expr_keyword_plus_(const expression& expr, eval_context& context)
+void promote_function(s_function* fn, std::uint8_t tier)
 {
-	if (expr.list.size() < 2)
-		throw invalid_keyword_list();
+	const function_template* templ = fn->templ;
+	if (templ->is_native)
+		return;
 
-	double ret = 0;
-	for (auto it = expr.list.begin() + 1; it != expr.list.end(); ++it)
+	if (templ->tier < 1 && tier >= 1)
 	{
-		variable v = eval_expr(*it);
-		if (v.type != var_type::number)
-			throw not_number_error();
-		ret += v.v_number;
+		// ߷     ϹǷ    ص ˴ϴ.
+		infer_types(*templ->expr);
+		templ->tier = 1;
+		log_tier_transition(fn, 0, 1);
 	}
 
-	return variable::number(ret);
+	if (templ->tier < 2 && tier >= 2 && !templ->jit_failed)
+	{
+		if (jit_compile(*templ))
+		{
+			templ->tier = 2;
+			log_tier_transition(fn, 1, 2);
+		}
+		else
+		{
+			log_tier_transition(fn, 1, 1, "jit failed");
+		}
+	}
 }
 
-variable eval_expr_keyword_minus_(const expression& expr, eval_context& context)
+void demote_function(s_function* fn)
 {
-	if (expr.list.size() == 2)
-	{
-		variable v = eval_expr(expr.list[1]);
-		if (v.type != var_type::number)
-			throw not_number_error();
+	fn->templ->tier = 1;
+	log_tier_transition(fn, 2, 1, "deoptimized");
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
-		return variable::number(-v.v_number);
-	}
-	else if (expr.list.size() == 3)
-	{
-		variable v1 = eval_expr(expr.list[1]);
-		if (v1.type != var_type::number)
-			throw not_number_error();
+#if defined(_M_X64) || defined(__x86_64__)
+# define LISCRIPT_JIT
+#endif
 
-		variable v2 = eval_expr(expr.list[2]);
-		if (v2.type != var_type::number)
-			throw not_number_error();
+namespace
+{
+	// helper  Դϴ. jit_run() ٽ ϴ.
+	std::exception_ptr jit_pending_exception;
 
-		return variable::number(v1.v_number - v2.v_number);
+	enum class jit_guard { number, conditional };
+
+	int jit_eval(const expression* expr, variable* out)
+	{
+		try
+		{
+			*out = eval_expr(*expr);
+			return 0;
+		}
+		catch (...)
+		{
+			jit_pending_exception = std::current_exception();
+			return 1;
+		}
 	}
-	else
+
+	void jit_getl(const expression* atom, variable* out)
 	{
-		throw invalid_keyword_list();
+		*out = load_local(*atom);
 	}
-}
 
-variable eval_expr_keyword_multiply_(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() < 2)
-		throw invalid_keyword_list();
+	int jit_setl(s_string* name, const variable* val)
+	{
+		try
+		{
+			assign_local(name, *val);
+			return 0;
+		}
+		catch (...)
+		{
+			jit_pending_exception = std::current_exception();
+			return 1;
+		}
+	}
 
-	double ret = 1;
-	for (auto it = expr.list.begin() + 1; it != expr.list.end(); ++it)
+	// idiv imod & | ^ Դϴ.  operand ̹ number ȮεǾ  lhs ϴ.
+	int jit_int_op(std::intptr_t op, variable* lhs, const variable* rhs)
 	{
-		variable v = eval_expr(*it);
-		if (v.type != var_type::number)
-			throw not_number_error();
-		ret *= v.v_number;
+		try
+		{
+			std::int64_t a = to_integer(lhs->v_number);
+			std::int64_t b = to_integer(rhs->v_number);
+			std::int64_t ret;
+			switch (op)
+			{
+				case 0: ret = a / b; break;
+				case 1: ret = a % b; break;
+				case 2: ret = a & b; break;
+				case 3: ret = a | b; break;
+				default: ret = a ^ b; break;
+			}
+			*lhs = variable::number(static_cast<double>(ret));
+			return 0;
+		}
+		catch (...)
+		{
+			jit_pending_exception = std::current_exception();
+			return 1;
+		}
 	}
 
-	return variable::number(ret);
-}
+	double jit_fmod(double a, double b)
+	{
+		return std::fmod(a, b);
+	}
 
-variable eval_expr_keyword_division_(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() != 3)
-		throw invalid_keyword_list();
+	// type guard   interpreter  ܸ غϰ, ݺǸ Լ deoptimizeմϴ.
+	void jit_guard_failed(const function_template* templ, std::intptr_t kind)
+	{
+		if (static_cast<jit_guard>(kind) == jit_guard::number)
+			jit_pending_exception = std::make_exception_ptr(not_number_error());
+		else
+			jit_pending_exception = std::make_exception_ptr(invalid_conditional());
 
-	variable v1 = eval_expr(expr.list[1]);
-	if (v1.type != var_type::number)
-		throw not_number_error();
+		if (++templ->jit_deopts >= jit_deopt_limit)
+		{
+			//      Ƿ jit_code template Բ մϴ.
+			templ->jit_entry = nullptr;
+			templ->jit_failed = true;
 
-	variable v2 = eval_expr(expr.list[2]);
-	if (v2.type != var_type::number)
-		throw not_number_error();
+			// guard   stackframe   Լ Դϴ.
+			if (!stackframe.empty() && stackframe.back().function->templ == templ)
+				demote_function(stackframe.back().function);
+			else
+				templ->tier = 1;
+		}
+	}
 
-	return variable::number(v1.v_number / v2.v_number);
-}
+	const std::size_t jit_max_nodes = 5000;
 
-variable eval_expr_keyword_modulo_(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() != 3)
-		throw invalid_keyword_list();
+	std::size_t count_nodes(const expression& expr)
+	{
+		std::size_t n = 1;
+		for (const auto& sub : expr.list)
+			n += count_nodes(sub);
+		return n;
+	}
 
-	variable v1 = eval_expr(expr.list[1]);
-	if (v1.type != var_type::number)
-		throw not_number_error();
+	bool is_atom(const expression& expr, const char* name)
+	{
+		return expr.type == expr_type::atom && std::strcmp(expr.value->ptr, name) == 0;
+	}
 
-	variable v2 = eval_expr(expr.list[2]);
-	if (v2.type != var_type::number)
-		throw not_number_error();
+	const char* list_keyword(const expression& expr)
+	{
+		if (expr.type != expr_type::list || expr.list.empty() || expr.list[0].type != expr_type::atom)
+			return nullptr;
+		return expr.list[0].value->ptr;
+	}
 
-	return variable::number(std::fmod(v1.v_number, v2.v_number));
-}
+	std::uint64_t double_bits(double d)
+	{
+		std::uint64_t bits;
+		std::memcpy(&bits, &d, sizeof(bits));
+		return bits;
+	}
 
-variable eval_expr_keyword_idiv(const expression & expr, eval_context & context)
-{
-	if (expr.list.size() != 3)
-		throw invalid_keyword_list();
+#ifdef LISCRIPT_JIT
+	enum reg { rax = 0, rcx = 1, rdx = 2, rbx = 3, rsp = 4, rbp = 5, rsi = 6, rdi = 7, r8 = 8, r9 = 9 };
 
-	variable v1 = eval_expr(expr.list[1]);
-	if (v1.type != var_type::number)
-		throw not_number_error();
+#ifdef _WIN32
+	const reg arg_regs[] = { rcx, rdx, r8, r9 };
+#else
+	const reg arg_regs[] = { rdi, rsi, rdx, rcx };
+#endif
 
-	variable v2 = eval_expr(expr.list[2]);
-	if (v2.type != var_type::number)
-		throw not_number_error();
+	// ʿ ɸ encodingϴ x86-64 assemblerԴϴ. б  rel32 ϴ.
+	class x64_emitter
+	{
+	public:
+		struct label
+		{
+			std::ptrdiff_t pos { -1 };
+			std::vector<std::size_t> fixups;
+		};
 
-	std::int64_t ret = to_integer(v1.v_number) / to_integer(v2.v_number);
-	return variable::number(static_cast<double>(ret));
-}
+		std::vector<std::uint8_t> code;
 
-variable eval_expr_keyword_imod(const expression & expr, eval_context & context)
-{
-	if (expr.list.size() != 3)
-		throw invalid_keyword_list();
+		void byte(std::uint8_t b) { code.push_back(b); }
+		void bytes(std::initializer_list<std::uint8_t> bs) { code.insert(code.end(), bs); }
+		void dword(std::uint32_t v)
+		{
+			for (int i = 0; i < 4; ++i)
+				byte(static_cast<std::uint8_t>(v >> (i * 8)));
+		}
+		void qword(std::uint64_t v)
+		{
+			for (int i = 0; i < 8; ++i)
+				byte(static_cast<std::uint8_t>(v >> (i * 8)));
+		}
 
-	variable v1 = eval_expr(expr.list[1]);
-	if (v1.type != var_type::number)
-		throw not_number_error();
+		// ModRM [rbp + disp32]
+		void rbp_operand(int r, std::int32_t disp)
+		{
+			byte(static_cast<std::uint8_t>(0x80 | ((r & 7) << 3) | rbp));
+			dword(static_cast<std::uint32_t>(disp));
+		}
 
-	variable v2 = eval_expr(expr.list[2]);
-	if (v2.type != var_type::number)
-		throw not_number_error();
+		void bind(label& l)
+		{
+			l.pos = static_cast<std::ptrdiff_t>(code.size());
+			for (std::size_t at : l.fixups)
+				patch_rel32(at, l.pos);
+			l.fixups.clear();
+		}
+		void jmp(label& l)
+		{
+			byte(0xE9);
+			rel32(l);
+		}
+		// cc: x86 condition code (0x4 = e, 0x5 = ne, 0x2 = b, 0x3 = ae, 0x6 = be, 0x7 = a). cc ^ 1 ݴ Դϴ.
+		void jcc(int cc, label& l)
+		{
+			bytes({ 0x0F, static_cast<std::uint8_t>(0x80 | cc) });
+			rel32(l);
+		}
 
-	std::int64_t ret = to_integer(v1.v_number) % to_integer(v2.v_number);
-	return variable::number(static_cast<double>(ret));
-}
+		void mov_imm64(reg r, std::uint64_t v)
+		{
+			bytes({ static_cast<std::uint8_t>(0x48 | (r >= 8 ? 1 : 0)), static_cast<std::uint8_t>(0xB8 | (r & 7)) });
+			qword(v);
+		}
+		void mov_imm64(reg r, const void* p)
+		{
+			mov_imm64(r, static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(p)));
+		}
+		void lea_rbp(reg r, std::int32_t disp)
+		{
+			bytes({ static_cast<std::uint8_t>(0x48 | (r >= 8 ? 4 : 0)), 0x8D });
+			rbp_operand(r, disp);
+		}
+		void call_abs(const void* fn)
+		{
+			mov_imm64(rax, fn);
+			bytes({ 0xFF, 0xD0 });
+		}
+		// test eax, eax
+		void test_eax() { bytes({ 0x85, 0xC0 }); }
 
-variable eval_expr_keyword_bitand_(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() != 3)
-		throw invalid_keyword_list();
+		// mov dword [rbp + disp], imm32
+		void mov_dword_rbp(std::int32_t disp, std::uint32_t v)
+		{
+			byte(0xC7);
+			rbp_operand(0, disp);
+			dword(v);
+		}
+		// cmp dword [rbp + disp], imm8
+		void cmp_dword_rbp(std::int32_t disp, std::uint8_t v)
+		{
+			byte(0x83);
+			rbp_operand(7, disp);
+			byte(v);
+		}
+		// cmp byte [rbp + disp], 0
+		void cmp_byte_rbp_zero(std::int32_t disp)
+		{
+			byte(0x80);
+			rbp_operand(7, disp);
+			byte(0);
+		}
+		// cmp qword [rbp + disp], 0
+		void cmp_qword_rbp_zero(std::int32_t disp)
+		{
+			bytes({ 0x48, 0x83 });
+			rbp_operand(7, disp);
+			byte(0);
+		}
+		// mov [rbp + disp], rax / mov rax, [rbp + disp]
+		void store_rax(std::int32_t disp) { bytes({ 0x48, 0x89 }); rbp_operand(rax, disp); }
+		void load_rax(std::int32_t disp) { bytes({ 0x48, 0x8B }); rbp_operand(rax, disp); }
+		// mov eax, [rbp + disp] / cmp eax, [rbp + disp] / cmp rax, [rbp + disp]
+		void load_eax(std::int32_t disp) { byte(0x8B); rbp_operand(rax, disp); }
+		void cmp_eax(std::int32_t disp) { byte(0x3B); rbp_operand(rax, disp); }
+		void cmp_rax(std::int32_t disp) { bytes({ 0x48, 0x3B }); rbp_operand(rax, disp); }
+		// movzx eax/ecx, byte [rbp + disp]
+		void movzx_byte(reg r, std::int32_t disp) { bytes({ 0x0F, 0xB6 }); rbp_operand(r, disp); }
+		// cmp eax, ecx
+		void cmp_eax_ecx() { bytes({ 0x39, 0xC8 }); }
+
+		// movsd xmm, [rbp + disp] / movsd [rbp + disp], xmm0
+		void load_sd(int xmm, std::int32_t disp) { bytes({ 0xF2, 0x0F, 0x10 }); rbp_operand(xmm, disp); }
+		void store_sd(std::int32_t disp) { bytes({ 0xF2, 0x0F, 0x11 }); rbp_operand(0, disp); }
+		// movq xmm0, rax
+		void movq_xmm0_rax() { bytes({ 0x66, 0x48, 0x0F, 0x6E, 0xC0 }); }
+		// movq xmm1, rax
+		void movq_xmm1_rax() { bytes({ 0x66, 0x48, 0x0F, 0x6E, 0xC8 }); }
+		// movapd xmm1, xmm0
+		void movapd_xmm1_xmm0() { bytes({ 0x66, 0x0F, 0x28, 0xC8 }); }
+		// op xmm0, xmm1 (0x58 add, 0x59 mul, 0x5C sub, 0x5E div)
+		void sd_op(std::uint8_t op) { bytes({ 0xF2, 0x0F, op, 0xC1 }); }
+		// xorpd xmm0, xmm1 / xorpd xmm1, xmm1
+		void xorpd_xmm0_xmm1() { bytes({ 0x66, 0x0F, 0x57, 0xC1 }); }
+		void zero_xmm1() { bytes({ 0x66, 0x0F, 0x57, 0xC9 }); }
+		// ucomisd xmm0, xmm1 / ucomisd xmm1, xmm0
+		void ucomisd_01() { bytes({ 0x66, 0x0F, 0x2E, 0xC1 }); }
+		void ucomisd_10() { bytes({ 0x66, 0x0F, 0x2E, 0xC8 }); }
+
+		// 16Ʈ variable : movups xmm0, [src] / movups [dst], xmm0
+		void load_var_rbp(std::int32_t disp) { bytes({ 0x0F, 0x10 }); rbp_operand(0, disp); }
+		void store_var_rbp(std::int32_t disp) { bytes({ 0x0F, 0x11 }); rbp_operand(0, disp); }
+		void load_var_rax() { bytes({ 0x0F, 0x10, 0x00 }); }
+		void store_var_rax() { bytes({ 0x0F, 0x11, 0x00 }); }
+		void store_var_rbx() { bytes({ 0x0F, 0x11, 0x03 }); }
+
+		void patch_dword(std::size_t at, std::uint32_t v)
+		{
+			for (int i = 0; i < 4; ++i)
+				code[at + i] = static_cast<std::uint8_t>(v >> (i * 8));
+		}
 
-	variable v1 = eval_expr(expr.list[1]);
-	if (v1.type != var_type::number)
-		throw not_number_error();
+	private:
+		void rel32(label& l)
+		{
+			std::size_t at = code.size();
+			dword(0);
+			if (l.pos >= 0)
+				patch_rel32(at, l.pos);
+			else
+				l.fixups.push_back(at);
+		}
+		void patch_rel32(std::size_t at, std::ptrdiff_t target)
+		{
+			patch_dword(at, static_cast<std::uint32_t>(target - static_cast<std::ptrdiff_t>(at + 4)));
+		}
+	};
 
-	variable v2 = eval_expr(expr.list[2]);
-	if (v2.type != var_type::number)
-		throw not_number_error();
+	/**
+	 * Լ  ϳ  űϴ.
+	 * Ǵ Լ int (variable* ret)̰, ߰ 16Ʈ stack slot variable ״ Ӵϴ.
+	 * slot k [rbp - 32 - 16k] ְ rbx ret մϴ.
+	 *  (number)  xmm0, б (branch)  flag jump ٷ ϴ.
+	 **/
+	class jit_compiler
+	{
+	public:
+		explicit jit_compiler(const function_template& templ)
+			: templ_(templ)
+		{
+		}
 
-	std::int64_t ret = to_integer(v1.v_number) & to_integer(v2.v_number);
-	return variable::number(static_cast<double>(ret));
-}
+		std::vector<std::uint8_t> compile()
+		{
+			// push rbp; mov rbp, rsp; push rbx; sub rsp, frame
+			a_.bytes({ 0x55, 0x48, 0x89, 0xE5, 0x53, 0x48, 0x81, 0xEC });
+			std::size_t frame_at = a_.code.size();
+			a_.dword(0);
+			// mov rbx, arg0
+			a_.bytes({ 0x48, 0x89, static_cast<std::uint8_t>(0xC0 | ((arg_regs[0] & 7) << 3) | rbx) });
+
+			int ret = alloc();
+			value(*templ_.expr, ret);
+			a_.load_var_rbp(slot(ret));
+			a_.store_var_rbx();
+			a_.bytes({ 0x31, 0xC0 }); // xor eax, eax
+			epilogue();
+
+			a_.bind(number_guard_);
+			guard_stub(jit_guard::number);
+			a_.bind(conditional_guard_);
+			guard_stub(jit_guard::conditional);
+
+			a_.bind(error_);
+			a_.byte(0xB8); // mov eax, 1
+			a_.dword(1);
+			epilogue();
+
+			// slot Ʒ Win64 shadow space 32Ʈ , call  rsp 16Ʈ ϴ.
+			a_.patch_dword(frame_at, static_cast<std::uint32_t>(16 * max_slots_ + 40));
+			return std::move(a_.code);
+		}
 
-variable eval_expr_keyword_bitor_(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() != 3)
-		throw invalid_keyword_list();
+	private:
+		static std::int32_t slot(int k) { return -32 - 16 * k; }
 
-	variable v1 = eval_expr(expr.list[1]);
-	if (v1.type != var_type::number)
-		throw not_number_error();
+		int alloc()
+		{
+			int k = depth_++;
+			if (depth_ > max_slots_)
+				max_slots_ = depth_;
+			return k;
+		}
 
-	variable v2 = eval_expr(expr.list[2]);
-	if (v2.type != var_type::number)
-		throw not_number_error();
+		void epilogue()
+		{
+			// mov rbx, [rbp - 8]; leave; ret
+			a_.bytes({ 0x48, 0x8B, 0x5D, 0xF8, 0xC9, 0xC3 });
+		}
 
-	std::int64_t ret = to_integer(v1.v_number) | to_integer(v2.v_number);
-	return variable::number(static_cast<double>(ret));
-}
+		void guard_stub(jit_guard kind)
+		{
+			a_.mov_imm64(arg_regs[0], &templ_);
+			a_.mov_imm64(arg_regs[1], static_cast<std::uint64_t>(kind));
+			a_.call_abs(reinterpret_cast<const void*>(&jit_guard_failed));
+			a_.jmp(error_);
+		}
 
-variable eval_expr_keyword_bitxor_(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() != 3)
-		throw invalid_keyword_list();
+		void check_status()
+		{
+			a_.test_eax();
+			a_.jcc(0x5, error_);
+		}
 
-	variable v1 = eval_expr(expr.list[1]);
-	if (v1.type != var_type::number)
-		throw not_number_error();
+		void store_type(int dst, var_type type)
+		{
+			a_.mov_dword_rbp(slot(dst), static_cast<std::uint32_t>(type));
+		}
+		void store_raw(int dst, std::uint64_t raw)
+		{
+			a_.mov_imm64(rax, raw);
+			a_.store_rax(slot(dst) + 8);
+		}
+		void store_number(int dst)
+		{
+			store_type(dst, var_type::number);
+			a_.store_sd(slot(dst) + 8);
+		}
+		void copy_from(int dst, const void* src)
+		{
+			a_.mov_imm64(rax, src);
+			a_.load_var_rax();
+			a_.store_var_rbp(slot(dst));
+		}
+		void set_prev(int src)
+		{
+			a_.load_var_rbp(slot(src));
+			a_.mov_imm64(rax, &prev_var);
+			a_.store_var_rax();
+		}
+		void clear_prev()
+		{
+			a_.mov_imm64(rax, &prev_var);
+			// mov dword [rax], undefined; mov qword [rax + 8], 0
+			a_.bytes({ 0xC7, 0x00 });
+			a_.dword(static_cast<std::uint32_t>(var_type::undefined));
+			a_.bytes({ 0x48, 0xC7, 0x40, 0x08 });
+			a_.dword(0);
+		}
 
-	variable v2 = eval_expr(expr.list[2]);
-	if (v2.type != var_type::number)
-		throw not_number_error();
+		void generic(const expression& expr, int dst)
+		{
+			a_.mov_imm64(arg_regs[0], &expr);
+			a_.lea_rbp(arg_regs[1], slot(dst));
+			a_.call_abs(reinterpret_cast<const void*>(&jit_eval));
+			check_status();
+		}
 
-	std::int64_t ret = to_integer(v1.v_number) ^ to_integer(v2.v_number);
-	return variable::number(static_cast<double>(ret));
-}
+		void getl(const expression& atom, int dst)
+		{
+			a_.mov_imm64(arg_regs[0], &atom);
+			a_.lea_rbp(arg_regs[1], slot(dst));
+			a_.call_abs(reinterpret_cast<const void*>(&jit_getl));
+		}
 
-variable eval_expr_keyword_and(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() < 2)
-		throw invalid_keyword_list();
+		static bool is_number_form(const expression& expr)
+		{
+			const char* kw = list_keyword(expr);
+			if (kw == nullptr)
+				return false;
 
-	for (auto it = expr.list.begin() + 1; it != expr.list.end(); ++it)
-	{
-		variable v = eval_expr(*it);
-		if (!to_conditional(v))
-			return variable::boolean(false);
-	}
+			std::size_t n = expr.list.size();
+			if (std::strcmp(kw, "+") == 0 || std::strcmp(kw, "*") == 0)
+				return n >= 2;
+			if (std::strcmp(kw, "-") == 0)
+				return n == 2 || n == 3;
+			return n == 3 && (std::strcmp(kw, "/") == 0 || std::strcmp(kw, "%") == 0 || int_op(kw) >= 0);
+		}
 
-	return variable::boolean(true);
-}
+		static int int_op(const char* kw)
+		{
+			static const char* const names[] = { "idiv", "imod", "&", "|", "^" };
+			for (int i = 0; i < 5; ++i)
+			{
+				if (std::strcmp(kw, names[i]) == 0)
+					return i;
+			}
+			return -1;
+		}
 
-variable eval_expr_keyword_or(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() < 2)
-		throw invalid_keyword_list();
+		//  keyword (operand  ٲ,   condition code)
+		static bool compare_form(const expression& expr, bool& swap, int& cc)
+		{
+			const char* kw = list_keyword(expr);
+			if (kw == nullptr || expr.list.size() != 3)
+				return false;
 
-	for (auto it = expr.list.begin() + 1; it != expr.list.end(); ++it)
-	{
-		variable v = eval_expr(*it);
-		if (to_conditional(v))
-			return variable::boolean(true);
-	}
+			// ucomisd NaN  CF ZF Ƿ a, ae  NaN 񱳰 ׻  ˴ϴ.
+			if (std::strcmp(kw, "<") == 0) { swap = true; cc = 0x7; }
+			else if (std::strcmp(kw, "<=") == 0) { swap = true; cc = 0x3; }
+			else if (std::strcmp(kw, ">") == 0) { swap = false; cc = 0x7; }
+			else if (std::strcmp(kw, ">=") == 0) { swap = false; cc = 0x3; }
+			else return false;
+			return true;
+		}
 
-	return variable::boolean(false);
-}
+		static bool is_equality_form(const expression& expr, bool& negate)
+		{
+			const char* kw = list_keyword(expr);
+			if (kw == nullptr || expr.list.size() != 3)
+				return false;
 
-variable eval_expr_keyword_not(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() != 2)
-		throw invalid_keyword_list();
+			if (std::strcmp(kw, "=") == 0)
+				negate = false;
+			else if (std::strcmp(kw, "/=") == 0)
+				negate = true;
+			else
+				return false;
+			return true;
+		}
 
-	variable v = eval_expr(expr.list[1]);
-	return variable::boolean(!to_conditional(v));
-}
+		static bool is_logical_form(const expression& expr)
+		{
+			const char* kw = list_keyword(expr);
+			if (kw == nullptr)
+				return false;
+			if (std::strcmp(kw, "not") == 0)
+				return expr.list.size() == 2;
+			return (std::strcmp(kw, "and") == 0 || std::strcmp(kw, "or") == 0) && expr.list.size() >= 2;
+		}
 
-variable eval_expr_keyword_eq_(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() != 3)
-		throw invalid_keyword_list();
+		// expr  slot dst variable ϴ.
+		void value(const expression& expr, int dst)
+		{
+			if (expr.type == expr_type::number)
+			{
+				store_type(dst, var_type::number);
+				store_raw(dst, double_bits(expr.number));
+				return;
+			}
+			if (expr.type == expr_type::string)
+			{
+				store_type(dst, var_type::object);
+				store_raw(dst, reinterpret_cast<std::uintptr_t>(expr.value->obj()));
+				return;
+			}
+			if (expr.type == expr_type::atom)
+			{
+				atom(expr, dst);
+				return;
+			}
 
-	variable v1 = eval_expr(expr.list[1]);
-	variable v2 = eval_expr(expr.list[2]);
+			bool swap, negate;
+			int cc;
+			if (is_number_form(expr))
+			{
+				number(expr);
+				store_number(dst);
+			}
+			else if (compare_form(expr, swap, cc) || is_equality_form(expr, negate) || is_logical_form(expr))
+			{
+				x64_emitter::label is_false, done;
+				branch(expr, false, is_false);
+				store_type(dst, var_type::boolean);
+				store_raw(dst, 1);
+				a_.jmp(done);
+				a_.bind(is_false);
+				store_type(dst, var_type::boolean);
+				store_raw(dst, 0);
+				a_.bind(done);
+			}
+			else
+			{
+				list(expr, dst);
+			}
+		}
 
-	return variable::boolean(v1 == v2);
-}
+		void atom(const expression& expr, int dst)
+		{
+			if (is_atom(expr, "true") || is_atom(expr, "false"))
+			{
+				store_type(dst, var_type::boolean);
+				store_raw(dst, is_atom(expr, "true") ? 1 : 0);
+			}
+			else if (is_atom(expr, "null"))
+			{
+				store_type(dst, var_type::object);
+				store_raw(dst, 0);
+			}
+			else if (is_atom(expr, "undefined"))
+			{
+				store_type(dst, var_type::undefined);
+				store_raw(dst, 0);
+			}
+			else if (is_atom(expr, "this"))
+			{
+				copy_from(dst, &this_var);
+			}
+			else if (is_atom(expr, "prev"))
+			{
+				copy_from(dst, &prev_var);
+			}
+			else if (is_atom(expr, "global"))
+			{
+				store_type(dst, var_type::object);
+				a_.mov_imm64(rax, &global_object);
+				a_.bytes({ 0x48, 0x8B, 0x00 }); // mov rax, [rax]
+				a_.store_rax(slot(dst) + 8);
+			}
+			else if (is_keyword(expr.value->ptr))
+			{
+				generic(expr, dst);
+			}
+			else
+			{
+				getl(expr, dst);
+			}
+		}
 
-variable eval_expr_keyword_ne_(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() != 3)
-		throw invalid_keyword_list();
+		void list(const expression& expr, int dst)
+		{
+			const char* kw = list_keyword(expr);
+			std::size_t n = expr.list.size();
 
-	variable v1 = eval_expr(expr.list[1]);
-	variable v2 = eval_expr(expr.list[2]);
+			if (kw == nullptr)
+			{
+				generic(expr, dst);
+			}
+			else if (std::strcmp(kw, "do") == 0 && n >= 2)
+			{
+				for (std::size_t i = 1; i < n; ++i)
+				{
+					value(expr.list[i], dst);
+					set_prev(dst);
+				}
+				clear_prev();
+			}
+			else if (std::strcmp(kw, "if") == 0 && n == 4)
+			{
+				x64_emitter::label is_false, done;
+				branch(expr.list[1], false, is_false);
+				value(expr.list[2], dst);
+				a_.jmp(done);
+				a_.bind(is_false);
+				value(expr.list[3], dst);
+				a_.bind(done);
+			}
+			else if (std::strcmp(kw, "while") == 0 && n == 3)
+			{
+				x64_emitter::label top, done;
+				store_type(dst, var_type::undefined);
+				store_raw(dst, 0);
+				a_.bind(top);
+				branch(expr.list[1], false, done);
+				value(expr.list[2], dst);
+				set_prev(dst);
+				a_.jmp(top);
+				a_.bind(done);
+				clear_prev();
+			}
+			else if ((std::strcmp(kw, "getl") == 0 && n == 2 && expr.list[1].type == expr_type::atom))
+			{
+				getl(expr.list[1], dst);
+			}
+			else if (std::strcmp(kw, "setl") == 0 && n == 3 && expr.list[1].type == expr_type::atom)
+			{
+				value(expr.list[2], dst);
+				a_.mov_imm64(arg_regs[0], expr.list[1].value);
+				a_.lea_rbp(arg_regs[1], slot(dst));
+				a_.call_abs(reinterpret_cast<const void*>(&jit_setl));
+				check_status();
+			}
+			else
+			{
+				generic(expr, dst);
+			}
+		}
 
-	return variable::boolean(v1 != v2);
-}
+		// expr ؼ number Ȯ  xmm0 Ӵϴ.
+		void number(const expression& expr)
+		{
+			if (expr.type == expr_type::number)
+			{
+				a_.mov_imm64(rax, double_bits(expr.number));
+				a_.movq_xmm0_rax();
+				return;
+			}
+			if (!is_number_form(expr))
+			{
+				int tmp = alloc();
+				value(expr, tmp);
+				a_.cmp_dword_rbp(slot(tmp), static_cast<std::uint8_t>(var_type::number));
+				a_.jcc(0x5, number_guard_);
+				a_.load_sd(0, slot(tmp) + 8);
+				--depth_;
+				return;
+			}
 
-variable eval_expr_keyword_lt_(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() != 3)
-		throw invalid_keyword_list();
+			const char* kw = list_keyword(expr);
+			std::size_t n = expr.list.size();
 
-	variable v1 = eval_expr(expr.list[1]);
-	if (v1.type != var_type::number)
-		throw not_number_error();
+			if (std::strcmp(kw, "-") == 0 && n == 2)
+			{
+				number(expr.list[1]);
+				a_.mov_imm64(rax, 0x8000000000000000ull);
+				a_.movq_xmm1_rax();
+				a_.xorpd_xmm0_xmm1();
+				return;
+			}
 
-	variable v2 = eval_expr(expr.list[2]);
-	if (v2.type != var_type::number)
-		throw not_number_error();
+			int op = int_op(kw);
+			if (op >= 0)
+			{
+				int lhs = alloc();
+				int rhs = alloc();
+				number(expr.list[1]);
+				store_number(lhs);
+				number(expr.list[2]);
+				store_number(rhs);
+				a_.mov_imm64(arg_regs[0], static_cast<std::uint64_t>(op));
+				a_.lea_rbp(arg_regs[1], slot(lhs));
+				a_.lea_rbp(arg_regs[2], slot(rhs));
+				a_.call_abs(reinterpret_cast<const void*>(&jit_int_op));
+				check_status();
+				a_.load_sd(0, slot(lhs) + 8);
+				depth_ -= 2;
+				return;
+			}
 
-	return variable::boolean(v1.v_number < v2.v_number);
-}
+			std::uint8_t sd;
+			if (std::strcmp(kw, "+") == 0) sd = 0x58;
+			else if (std::strcmp(kw, "*") == 0) sd = 0x59;
+			else if (std::strcmp(kw, "-") == 0) sd = 0x5C;
+			else if (std::strcmp(kw, "/") == 0) sd = 0x5E;
+			else sd = 0; // %
 
-variable eval_expr_keyword_lte_(const expression& expr, eval_context& context)
-{
-	if (expr.list.size() != 3)
-		throw invalid_keyword_list();
+			number(expr.list[1]);
+			if (sd == 0x58)
+			{
+				// interpreter 0 ϱ ϹǷ -0.0 + 0.0 = 0.0  ݴϴ.
+				a_.zero_xmm1();
+				a_.sd_op(0x58);
+			}
 
-	variable v1 = eval_expr(expr.list[1]);
-	if (v1.type != var_type::number)
-		throw not_number_error();
+			int acc = alloc();
+			for (std::size_t i = 2; i < n; ++i)
+			{
+				a_.store_sd(slot(acc) + 8);
+				number(expr.list[i]);
+				a_.movapd_xmm1_xmm0();
+				a_.load_sd(0, slot(acc) + 8);
+				if (sd != 0)
+					a_.sd_op(sd);
+				else
+					a_.call_abs(reinterpret_cast<const void*>(&jit_fmod));
+			}
+			--depth_;
+		}
 
-	variable v2 = eval_expr(expr.list[2]);
-	if (v2.type != var_type::number)
-		throw not_number_error();
+		// expr conditional ؼ   jump_if  target бմϴ.
+		void branch(const expression& expr, bool jump_if, x64_emitter::label& target)
+		{
+			bool swap, negate;
+			int cc;
+			const char* kw = list_keyword(expr);
 
-	return variable::boolean(v1.v_number <= v2.v_number);
+			if (compare_form(expr, swap, cc))
+			{
+				int lhs = alloc();
+				number(expr.list[1]);
+				a_.store_sd(slot(lhs) + 8);
+				number(expr.list[2]);
+				a_.load_sd(1, slot(lhs) + 8);
+				--depth_;
+				// xmm1 =  operand, xmm0 =  operand
+				if (swap)
+					a_.ucomisd_01();
+				else
+					a_.ucomisd_10();
+				a_.jcc(jump_if ? cc : (cc ^ 1), target);
+			}
+			else if (is_equality_form(expr, negate))
+			{
+				int lhs = alloc();
+				int rhs = alloc();
+				value(expr.list[1], lhs);
+				value(expr.list[2], rhs);
+				depth_ -= 2;
+
+				// variable::operator==  type  մϴ. boolean  1Ʈ ȿմϴ.
+				x64_emitter::label not_equal, equal, not_boolean;
+				a_.load_eax(slot(lhs));
+				a_.cmp_eax(slot(rhs));
+				a_.jcc(0x5, not_equal);
+				a_.cmp_dword_rbp(slot(lhs), static_cast<std::uint8_t>(var_type::boolean));
+				a_.jcc(0x5, not_boolean);
+				a_.movzx_byte(rax, slot(lhs) + 8);
+				a_.movzx_byte(rcx, slot(rhs) + 8);
+				a_.cmp_eax_ecx();
+				a_.jcc(0x5, not_equal);
+				a_.jmp(equal);
+				a_.bind(not_boolean);
+				a_.load_rax(slot(lhs) + 8);
+				a_.cmp_rax(slot(rhs) + 8);
+				a_.jcc(0x5, not_equal);
+				a_.bind(equal);
+				if (jump_if != negate)
+				{
+					a_.jmp(target);
+					a_.bind(not_equal);
+				}
+				else
+				{
+					x64_emitter::label done;
+					a_.jmp(done);
+					a_.bind(not_equal);
+					a_.jmp(target);
+					a_.bind(done);
+				}
+			}
+			else if (kw != nullptr && std::strcmp(kw, "not") == 0 && expr.list.size() == 2)
+			{
+				branch(expr.list[1], !jump_if, target);
+			}
+			else if (is_logical_form(expr))
+			{
+				// and: ϳ ̸ , or: ϳ ̸ 
+				bool short_value = (std::strcmp(kw, "or") == 0);
+				if (jump_if == short_value)
+				{
+					for (std::size_t i = 1; i < expr.list.size(); ++i)
+						branch(expr.list[i], short_value, target);
+				}
+				else
+				{
+					x64_emitter::label skip;
+					for (std::size_t i = 1; i < expr.list.size(); ++i)
+						branch(expr.list[i], short_value, skip);
+					a_.jmp(target);
+					a_.bind(skip);
+				}
+			}
+			else if (is_atom(expr, "true") || is_atom(expr, "false"))
+			{
+				if (is_atom(expr, "true") == jump_if)
+					a_.jmp(target);
+			}
+			else
+			{
+				int tmp = alloc();
+				value(expr, tmp);
+				--depth_;
+
+				// to_conditional()
+				x64_emitter::label done, not_boolean, not_object;
+				int jcc_taken = jump_if ? 0x5 : 0x4;
+				a_.cmp_dword_rbp(slot(tmp), static_cast<std::uint8_t>(var_type::boolean));
+				a_.jcc(0x5, not_boolean);
+				a_.cmp_byte_rbp_zero(slot(tmp) + 8);
+				a_.jcc(jcc_taken, target);
+				a_.jmp(done);
+				a_.bind(not_boolean);
+				a_.cmp_dword_rbp(slot(tmp), static_cast<std::uint8_t>(var_type::object));
+				a_.jcc(0x5, not_object);
+				a_.cmp_qword_rbp_zero(slot(tmp) + 8);
+				a_.jcc(jcc_taken, target);
+				a_.jmp(done);
+				a_.bind(not_object);
+				a_.cmp_dword_rbp(slot(tmp), static_cast<std::uint8_t>(var_type::undefined));
+				a_.jcc(0x5, conditional_guard_);
+				if (!jump_if)
+					a_.jmp(target);
+				a_.bind(done);
+			}
+		}
+
+		const function_template& templ_;
+		x64_emitter a_;
+		x64_emitter::label error_, number_guard_, conditional_guard_;
+		int depth_ { 0 };
+		int max_slots_ { 0 };
+	};
+#endif
 }
 
-variable eval_expr_keyword_gt_(const expression& expr, eval_context& context)
+bool jit_compile(const function_template& templ)
 {
-	if (expr.list.size() != 3)
-		throw invalid_keyword_list();
+#ifdef LISCRIPT_JIT
+	if (templ.is_native || count_nodes(*templ.expr) > jit_max_nodes)
+	{
+		templ.jit_failed = true;
+		return false;
+	}
 
-	variable v1 = eval_expr(expr.list[1]);
-	if (v1.type != var_type::number)
-		throw not_number_error();
+	std::vector<std::uint8_t> code = jit_compiler(templ).compile();
 
-	variable v2 = eval_expr(expr.list[2]);
-	if (v2.type != var_type::number)
-		throw not_number_error();
+	std::unique_ptr<jitmem::block> block(new jitmem::block(code.size()));
+	if (block->get() == nullptr)
+	{
+		templ.jit_failed = true;
+		return false;
+	}
+	std::memcpy(block->get(), code.data(), code.size());
+	if (!block->protect())
+	{
+		templ.jit_failed = true;
+		return false;
+	}
 
-	return variable::boolean(v1.v_number > v2.v_number);
+	templ.jit_entry = reinterpret_cast<jit_entry_t>(block->get());
+	templ.jit_code = std::move(block);
+	return true;
+#else
+	templ.jit_failed = true;
+	return false;
+#endif
 }
 
-variable eval_expr_keyword_gte_(const expression& expr, eval_context& context)
+variable jit_run(const function_template& templ)
 {
-	if (expr.list.size() != 3)
-		throw invalid_keyword_list();
-
-	variable v1 = eval_expr(expr.list[1]);
-	if (v1.type != var_type::number)
-		throw not_number_error();
-
-	variable v2 = eval_expr(expr.list[2]);
-	if (v2.type != var_type::number)
-		throw not_number_error();
-
-	return variable::boolean(v1.v_number >= v2.v_number);
+	variable ret;
+	if (templ.jit_entry(&ret) != 0)
+	{
+		std::exception_ptr ex = jit_pending_exception;
+		jit_pending_exception = nullptr;
+		std::rethrow_exception(ex);
+	}
+	return ret;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void print_var(std::ostream& strm, variable var, int indent /* = 0 */)
+namespace
 {
-	if (var.type == var_type::boolean)
+	std::unordered_map<std::string, aot::module_fn>& aot_modules()
 	{
-		conlib::setcolor_block scb(conlib::color::darkyellow);
-		strm << (var.v_boolean ? "true" : "false");
+		static std::unordered_map<std::string, aot::module_fn> modules;
+		return modules;
 	}
-	else if (var.type == var_type::number)
+
+	//  ҽ ڵ    ASCII  byte 8 escape ϴ.
+	std::string cpp_string_literal(const char* ptr, std::size_t size)
 	{
-		conlib::setcolor_block scb(conlib::color::darkyellow);
-		strm << var.v_number;
+		std::string ret = "\"";
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			unsigned char ch = static_cast<unsigned char>(ptr[i]);
+			if (ch == '"' || ch == '\\')
+			{
+				ret += '\\';
+				ret += static_cast<char>(ch);
+			}
+			else if (ch >= 0x20 && ch < 0x7F && ch != '?')
+			{
+				ret += static_cast<char>(ch);
+			}
+			else
+			{
+				char buf[8];
+				std::sprintf(buf, "\\%03o", ch);
+				ret += buf;
+			}
+		}
+		ret += '"';
+		return ret;
 	}
-	else if (var.type == var_type::undefined)
+
+	std::string cpp_number_literal(double d)
 	{
-		conlib::setcolor_block scb(conlib::color::darkgray);
-		strm << "(undefined)";
+		if (std::isnan(d))
+			return "std::numeric_limits<double>::quiet_NaN()";
+		if (std::isinf(d))
+			return d > 0 ? "std::numeric_limits<double>::infinity()" : "(-std::numeric_limits<double>::infinity())";
+
+		std::ostringstream strm;
+		strm << std::setprecision(17) << d;
+		std::string ret = strm.str();
+		if (ret.find_first_of(".eE") == std::string::npos)
+			ret += ".0";
+		return (d < 0) ? "(" + ret + ")" : ret;
 	}
-	else
+
+	// read_expr() ٽ   ִ ҽ · ϴ.
+	void write_source(std::ostream& strm, const expression& expr)
 	{
-		assert(var.type == var_type::object);
+		if (expr.type == expr_type::list)
+		{
+			strm << '(';
+			for (std::size_t i = 0; i < expr.list.size(); ++i)
+			{
+				if (i != 0)
+					strm << ' ';
+				write_source(strm, expr.list[i]);
+			}
+			strm << ')';
+		}
+		else if (expr.type == expr_type::string)
+		{
+			strm << '"';
+			for (std::size_t i = 0; i < expr.value->size; ++i)
+			{
+				char ch = expr.value->ptr[i];
+				if (ch == '\\')
+					strm << "\\\\";
+				else if (ch == '\n')
+					strm << "\\n";
+				else if (ch == '\t')
+					strm << "\\t";
+				else
+					strm << ch;
+			}
+			strm << '"';
+		}
+		else if (expr.type == expr_type::number)
+		{
+			// read_expr()   ϹǷ, fold_constants()    ϴ.
+			double d = expr.number;
+			if (std::signbit(d))
+			{
+				expression abs;
+				abs.type = expr_type::number;
+				abs.number = -d;
 
-		if (var.v_object == nullptr)
+				strm << "(- ";
+				write_source(strm, abs);
+				strm << ')';
+			}
+			else if (std::isinf(d))
+				strm << "1e999";
+			else
+				strm << std::setprecision(17) << d;
+		}
+		else
 		{
-			conlib::setcolor_block scb(conlib::color::darkgray);
-			strm << "(null)";
+			strm << expr.value->ptr;
 		}
-		else if (var.v_object->type == object_type::string)
+	}
+
+	/**
+	 * liscript ҽ C++ ҽ űϴ.
+	 * expression ϳ variable   C++ expression ϳ ǰ,
+	 *   ʿ  ٷ ȣϴ lambda Դϴ.
+	 * func native Լ  ǰ,     ҽ  aot::eval() մϴ.
+	 **/
+	class aot_compiler
+	{
+	public:
+		void add(const expression& expr)
 		{
-			strm << '"' << ((s_string*)var.v_object)->ptr << '"';
+			top_.push_back(compile(expr));
 		}
-		else if (var.v_object->type == object_type::function)
+
+		void write(std::ostream& out, const std::string& module_name) const
 		{
-			conlib::setcolor_block scb(conlib::color::darkcyan);
-			s_function* fn = (s_function*)var.v_object;
+			out << "// generated by liscript --aot (module " << module_name << "). do not edit.\n\n";
+			out << "#include \"aot.h\"\n\n";
+			out << "#include <cmath>\n#include <limits>\n\n";
+			out << "namespace\n{\n";
+			//  ʴ table  ʽϴ. -Wall   unused variable   ʰ մϴ.
+			if (!names_.empty())
+				out << "\ts_string* n_[" << names_.size() << "];\n";
+			if (!strings_.empty())
+				out << "\tvariable s_[" << strings_.size() << "];\n";
+			if (!fallbacks_.empty())
+				out << "\tconst expression* x_[" << fallbacks_.size() << "];\n";
+			if (!functions_.empty())
+				out << "\tconst function_template* t_[" << functions_.size() << "];\n";
+
+			for (std::size_t i = 0; i < functions_.size(); ++i)
+			{
+				out << "\n\tvariable f" << i << "(variable, s_array*)\n\t{\n";
+				out << "\t\treturn " << functions_[i].body << ";\n\t}\n";
+			}
+
+			out << "\n\tvoid init()\n\t{\n";
+			for (std::size_t i = 0; i < names_.size(); ++i)
+				out << "\t\tn_[" << i << "] = aot::name(" << names_[i] << ");\n";
+			for (std::size_t i = 0; i < strings_.size(); ++i)
+				out << "\t\ts_[" << i << "] = aot::string(" << strings_[i] << ");\n";
+			for (std::size_t i = 0; i < fallbacks_.size(); ++i)
+				out << "\t\tx_[" << i << "] = aot::parse(" << fallbacks_[i] << ");\n";
+			for (std::size_t i = 0; i < functions_.size(); ++i)
+			{
+				const auto& fn = functions_[i];
+				if (fn.parameters.empty())
+				{
+					out << "\t\tt_[" << i << "] = aot::native_template(nullptr, 0, "
+						<< (fn.is_variadic ? "true" : "false") << ", f" << i << ");\n";
+				}
+				else
+				{
+					out << "\t\t{\n\t\t\tstatic const char* const p[] = { ";
+					for (std::size_t j = 0; j < fn.parameters.size(); ++j)
+						out << (j != 0 ? ", " : "") << fn.parameters[j];
+					out << " };\n\t\t\tt_[" << i << "] = aot::native_template(p, " << fn.parameters.size() << ", "
+						<< (fn.is_variadic ? "true" : "false") << ", f" << i << ");\n\t\t}\n";
+				}
+			}
+			out << "\t}\n";
+
+			out << "\n\tvariable module_main()\n\t{\n";
+			out << "\t\tstatic bool initialized = false;\n";
+			out << "\t\tif (!initialized)\n\t\t{\n\t\t\tinit();\n\t\t\tinitialized = true;\n\t\t}\n\n";
+			out << "\t\tvariable ret = variable::undefined();\n";
+			for (const auto& stmt : top_)
+				out << "\t\tret = " << stmt << ";\n";
+			out << "\t\treturn ret;\n\t}\n\n";
+			out << "\taot::module_registrar registrar(" << cpp_string_literal(module_name.c_str(), module_name.size())
+				<< ", module_main);\n";
+			out << "}\n";
+		}
+
+	private:
+		struct function_entry
+		{
+			std::vector<std::string> parameters;
+			bool is_variadic;
+			std::string body;
+		};
+
+		static std::string lambda(const std::string& body)
+		{
+			return "[&]() -> variable { " + body + " }()";
+		}
 
-			strm << "(func (";
-			bool first = true;
-			for (const auto& p : fn->parameters)
-			{
-				if (!first)
-					strm << ", ";
-				first = false;
+		std::string temp()
+		{
+			return "v" + std::to_string(temp_count_++);
+		}
 
-				strm << p->ptr;
-			}
-			if (!fn->is_variadic)
+		std::string name(s_string* str)
+		{
+			std::string lit = cpp_string_literal(str->ptr, str->size);
+			auto it = name_index_.find(lit);
+			if (it == name_index_.end())
 			{
-				strm << ") ";
+				it = name_index_.insert({ lit, names_.size() }).first;
+				names_.push_back(lit);
 			}
-			else
+			return "n_[" + std::to_string(it->second) + "]";
+		}
+
+		std::string string(s_string* str)
+		{
+			std::string lit = cpp_string_literal(str->ptr, str->size);
+			auto it = string_index_.find(lit);
+			if (it == string_index_.end())
 			{
-				if (first)
-					strm << "...) ";
-				else
-					strm << ", ...) ";
+				it = string_index_.insert({ lit, strings_.size() }).first;
+				strings_.push_back(lit);
 			}
+			return "s_[" + std::to_string(it->second) + "]";
+		}
 
-			auto it = fn->obj()->vars.find(str_prototype);
-			bool ctor = false;
-			if (it != fn->obj()->vars.end())
-			{
-				if (it->second.type == var_type::object && it->second.v_object != nullptr)
-				{
-					conlib::setcolor_block scb(conlib::color::cyan);
+		std::string fallback(const expression& expr)
+		{
+			std::ostringstream strm;
+			write_source(strm, expr);
+			std::string src = strm.str();
+			fallbacks_.push_back(cpp_string_literal(src.c_str(), src.size()));
+			return "aot::eval(x_[" + std::to_string(fallbacks_.size() - 1) + "])";
+		}
 
-					s_object* proto = it->second.v_object;
-					if (proto->name->size != 0)
-					{
-						strm << "<" << proto->name->ptr << ">";
-					}
-					else
-					{
-						strm << "<";
-						conlib::setcolor_block scb(conlib::color::darkgray);
-						strm << "(unknown)";
-						scb.restore();
-						strm << ">";
-					}
-					ctor = true;
-				}
-			}
-			if (!ctor)
+		//     迭  (, ) ϴ.
+		std::string items(const expression& expr, std::size_t from, std::string& args)
+		{
+			std::size_t count = expr.list.size() - from;
+			if (count == 0)
 			{
-				strm << "(..)";
+				args = "nullptr, 0";
+				return "";
 			}
-			strm << ")";
+
+			std::string arr = temp();
+			std::string decl = "variable " + arr + "[] = { ";
+			for (std::size_t i = from; i < expr.list.size(); ++i)
+				decl += (i != from ? ", " : "") + compile(expr.list[i]);
+			decl += " }; ";
+			args = arr + ", " + std::to_string(count);
+			return decl;
 		}
-		else if (var.v_object->type == object_type::array)
+
+		std::string number(const expression& expr)
 		{
-			s_array* ar = (s_array*)var.v_object;
+			if (expr.type == expr_type::number)
+				return cpp_number_literal(expr.number);
+			return "aot::number(" + compile(expr) + ")";
+		}
+
+		std::string compile(const expression& expr)
+		{
+			if (expr.type == expr_type::number)
+				return "variable::number(" + cpp_number_literal(expr.number) + ")";
+			if (expr.type == expr_type::string)
+				return string(expr.value);
+			if (expr.type == expr_type::atom)
+				return atom(expr);
+
+			if (expr.list.empty())
+				return "variable::undefined()";
+
+			const char* kw = list_keyword(expr);
+			if (kw != nullptr && list_keyword_map.find(kw) != list_keyword_map.end())
+				return keyword(expr, kw);
+
+			return call(expr);
+		}
+
+		std::string atom(const expression& expr)
+		{
+			if (is_atom(expr, "true"))
+				return "variable::boolean(true)";
+			if (is_atom(expr, "false"))
+				return "variable::boolean(false)";
+			if (is_atom(expr, "null"))
+				return "variable::object(nullptr)";
+			if (is_atom(expr, "undefined"))
+				return "variable::undefined()";
+			if (is_atom(expr, "this"))
+				return "this_var";
+			if (is_atom(expr, "prev"))
+				return "prev_var";
+			if (is_atom(expr, "global"))
+				return "variable::object(global_object)";
+			if (atom_keyword_map.find(expr.value->ptr) != atom_keyword_map.end())
+				return fallback(expr);
+			return "aot::getl(" + name(expr.value) + ")";
+		}
+
+		std::string call(const expression& expr)
+		{
+			if (expr.list.size() <= 1)
+				return fallback(expr);
 
-			if (ar->vector.empty())
+			std::string t = temp(), f = temp();
+			std::string body = "variable " + t + " = " + compile(expr.list[0]) + "; ";
+			if (expr.list[1].type == expr_type::atom)
 			{
-				strm << "[ ]";
+				body += "s_function* " + f + " = aot::method(" + t + ", " + name(expr.list[1].value) + "); ";
+				body += "if (" + f + " == nullptr) " + f + " = aot::function(" + compile(expr.list[1]) + "); ";
 			}
 			else
 			{
-				std::string str_indent((indent + 1) * 2, ' ');
-				bool first = true;
+				body += "s_function* " + f + " = aot::function(" + compile(expr.list[1]) + "); ";
+			}
 
-				for (variable var : ar->vector)
-				{
-					if (first)
-						strm << "[\n" << str_indent;
-					else
-						strm << ",\n" << str_indent;
-					first = false;
+			std::string args;
+			body += items(expr, 2, args);
+			body += "return aot::call(" + f + ", " + t + ", " + args + ");";
+			return lambda(body);
+		}
 
-					print_var(strm, var, indent + 1);
-				}
-				strm << '\n' << std::string(indent * 2, ' ') << ']';
-			}
+		std::string binary_number(const expression& expr, const std::string& result)
+		{
+			std::string a = temp(), b = temp();
+			std::string r = result;
+			boost::replace_all(r, "$a", a);
+			boost::replace_all(r, "$b", b);
+			return lambda("double " + a + " = " + number(expr.list[1]) + "; double " + b + " = " + number(expr.list[2]) + "; "
+				+ "return " + r + ";");
 		}
-		else
+
+		std::string keyword(const expression& expr, const std::string& kw)
 		{
-			assert(var.v_object->type == object_type::object);
+			std::size_t n = expr.list.size();
 
-			if (var.v_object->proto == nullptr)
+			if (kw == "do" && n >= 2)
 			{
-				conlib::setcolor_block scb(conlib::color::darkcyan);
-				strm << "<";
-				conlib::setcolor(conlib::color::darkgray);
-				strm << "(raw)";
-				scb.restore();
-				strm << "> ";
+				std::string r = temp();
+				std::string body = "variable " + r + "; ";
+				for (std::size_t i = 1; i < n; ++i)
+					body += r + " = " + compile(expr.list[i]) + "; prev_var = " + r + "; ";
+				body += "prev_var = variable::undefined(); return " + r + ";";
+				return lambda(body);
 			}
-			else if (var.v_object->proto != p_Object)
+			if (kw == "if" && n == 4)
 			{
-				conlib::setcolor_block scb(conlib::color::darkcyan);
-				s_string* name = var.v_object->proto->name;
-				strm << "<";
-				if (name->size != 0)
+				return "(to_conditional(" + compile(expr.list[1]) + ") ? " + compile(expr.list[2]) + " : " + compile(expr.list[3]) + ")";
+			}
+			if (kw == "while" && n == 3)
+			{
+				std::string r = temp();
+				return lambda("variable " + r + " = variable::undefined(); while (to_conditional(" + compile(expr.list[1]) + ")) { "
+					+ r + " = " + compile(expr.list[2]) + "; prev_var = " + r + "; } prev_var = variable::undefined(); return " + r + ";");
+			}
+			if ((kw == "+" || kw == "*") && n >= 2)
+			{
+				std::string r = temp();
+				std::string body = "double " + r + " = " + (kw == "+" ? "0" : "1") + "; ";
+				for (std::size_t i = 1; i < n; ++i)
+					body += r + " " + kw + "= " + number(expr.list[i]) + "; ";
+				body += "return variable::number(" + r + ");";
+				return lambda(body);
+			}
+			if (kw == "-" && n == 2)
+				return "variable::number(-" + number(expr.list[1]) + ")";
+			if (n == 3)
+			{
+				if (kw == "-" || kw == "/")
+					return binary_number(expr, "variable::number($a " + kw + " $b)");
+				if (kw == "%")
+					return binary_number(expr, "variable::number(std::fmod($a, $b))");
+				if (kw == "<" || kw == "<=" || kw == ">" || kw == ">=")
+					return binary_number(expr, "variable::boolean($a " + kw + " $b)");
+
+				const char* int_ops[][2] = { { "idiv", "/" }, { "imod", "%" }, { "&", "&" }, { "|", "|" }, { "^", "^" } };
+				for (const auto& op : int_ops)
 				{
-					strm << var.v_object->proto->name->ptr;
+					if (kw == op[0])
+						return binary_number(expr, std::string("variable::number(static_cast<double>(to_integer($a) ") + op[1] + " to_integer($b)))");
 				}
-				else
+
+				if (kw == "=" || kw == "/=")
 				{
-					conlib::setcolor_block scb(conlib::color::darkgray);
-					strm << "(unknown)";
+					std::string a = temp(), b = temp();
+					return lambda("variable " + a + " = " + compile(expr.list[1]) + "; variable " + b + " = " + compile(expr.list[2]) + "; "
+						+ "return variable::boolean(" + a + (kw == "=" ? " == " : " != ") + b + ");");
 				}
-				strm << "> ";
 			}
+			if ((kw == "and" || kw == "or") && n >= 2)
+			{
+				bool is_and = (kw == "and");
+				std::string body;
+				for (std::size_t i = 1; i < n; ++i)
+				{
+					body += std::string("if (") + (is_and ? "!" : "") + "to_conditional(" + compile(expr.list[i]) + ")) return variable::boolean("
+						+ (is_and ? "false" : "true") + "); ";
+				}
+				body += std::string("return variable::boolean(") + (is_and ? "true" : "false") + ");";
+				return lambda(body);
+			}
+			if (kw == "not" && n == 2)
+				return "variable::boolean(!to_conditional(" + compile(expr.list[1]) + "))";
+			if (kw == "getl" && n == 2 && expr.list[1].type == expr_type::atom)
+				return "aot::getl(" + name(expr.list[1].value) + ")";
+			if (kw == "setl" && n == 3 && expr.list[1].type == expr_type::atom)
+			{
+				std::string v = temp();
+				return lambda("variable " + v + " = " + compile(expr.list[2]) + "; aot::setl(" + name(expr.list[1].value) + ", " + v + "); return " + v + ";");
+			}
+			if (kw == "getf" && (n == 2 || n == 3) && expr.list[n - 1].type == expr_type::atom)
+			{
+				std::string obj = (n == 3) ? compile(expr.list[1]) : "this_var";
+				return "aot::getf(aot::field_object(" + obj + "), " + name(expr.list[n - 1].value) + ")";
+			}
+			if (kw == "setf" && (n == 3 || n == 4) && expr.list[n - 2].type == expr_type::atom)
+			{
+				std::string o = temp(), v = temp();
+				std::string obj = (n == 4) ? compile(expr.list[1]) : "this_var";
+				return lambda("s_object* " + o + " = aot::field_object(" + obj + "); variable " + v + " = " + compile(expr.list[n - 1]) + "; "
+					+ "aot::setf(" + o + ", " + name(expr.list[n - 2].value) + ", " + v + "); return " + v + ";");
+			}
+			if (kw == "new" && n >= 2)
+			{
+				std::string c = temp(), args;
+				std::string body = "s_function* " + c + " = aot::constructor(" + compile(expr.list[1]) + "); ";
+				body += items(expr, 2, args);
+				body += "return aot::construct(" + c + ", " + args + ");";
+				return lambda(body);
+			}
+			if (kw == "array")
+			{
+				std::string args;
+				std::string decl = items(expr, 1, args);
+				return decl.empty() ? "aot::array(nullptr, 0)" : lambda(decl + "return aot::array(" + args + ");");
+			}
+			if (kw == "func")
+			{
+				return function(expr);
+			}
+
+			return fallback(expr);
+		}
+
+		std::string function(const expression& expr)
+		{
+			// compile_function_template()  縸 ϰ,  interpreter  ܸ  Ӵϴ.
+			const expression* params;
+			const expression* body;
+			s_string* fn_name = nullptr;
 
-			if (var.v_object->vars.empty())
+			if (expr.list.size() == 3)
 			{
-				strm << "{ }";
+				params = &expr.list[1];
+				body = &expr.list[2];
+			}
+			else if (expr.list.size() == 4 && expr.list[1].type == expr_type::atom)
+			{
+				fn_name = expr.list[1].value;
+				params = &expr.list[2];
+				body = &expr.list[3];
 			}
 			else
 			{
-				std::string str_indent((indent + 1) * 2, ' ');
-				bool first = true;
+				return fallback(expr);
+			}
 
-				for (const auto& pr : var.v_object->vars)
-				{
-					if (first)
-						strm << "{\n" << str_indent;
-					else
-						strm << ",\n" << str_indent;
-					first = false;
+			if (params->type != expr_type::list)
+				return fallback(expr);
 
-					strm << pr.first->ptr << ": ";
-					print_var(strm, pr.second, indent + 1);
+			function_entry fn;
+			fn.is_variadic = false;
+			for (const auto& p : params->list)
+			{
+				if (fn.is_variadic || p.type != expr_type::atom)
+					return fallback(expr);
+
+				if (std::strcmp(p.value->ptr, "...") == 0)
+				{
+					fn.is_variadic = true;
+					continue;
 				}
-				strm << '\n' << std::string(indent * 2, ' ') << '}';
+				else if (is_keyword(p.value->ptr))
+				{
+					return fallback(expr);
+				}
+
+				fn.parameters.push_back(cpp_string_literal(p.value->ptr, p.value->size));
 			}
+
+			std::size_t index = functions_.size();
+			functions_.push_back(std::move(fn));
+			std::string compiled = compile(*body);
+			functions_[index].body = std::move(compiled);
+
+			return "aot::make_function(t_[" + std::to_string(index) + "], " + (fn_name ? name(fn_name) : std::string("nullptr")) + ")";
+		}
+
+		std::vector<std::string> names_, strings_, fallbacks_;
+		std::unordered_map<std::string, std::size_t> name_index_, string_index_;
+		std::vector<function_entry> functions_;
+		std::vector<std::string> top_;
+		std::size_t temp_count_ { 0 };
+	};
+}
+
+void aot_transpile(std::istream& in, std::ostream& out, const std::string& module_name)
+{
+	aot_compiler compiler;
+	std::vector<std::shared_ptr<expression>> exprs;
+
+	while (!in.eof())
+	{
+		auto expr = std::make_shared<expression>();
+		if (read_expr(in, *expr, expr))
+		{
+			optimize_expr(*expr);
+			compiler.add(*expr);
+			exprs.push_back(std::move(expr));
 		}
 	}
+
+	compiler.write(out, module_name);
 }
 
-void dump_expr(const expression& expr, int indent /* = 0 */)
+variable aot_load_module(const std::string& name)
 {
-	std::string str_indent(indent * 2, ' ');
+	auto it = aot_modules().find(name);
+	if (it == aot_modules().end())
+		throw module_not_found_error();
 
-	std::cout << str_indent;
+	// module ֻ expr  ؼ ó global scope մϴ.
+	// loadModule θ frame    setl  frame   Ǿ ȣ  ϴ.
+	struct global_scope_guard
+	{
+		std::list<frame_entry> saved;
 
-	if (expr.type == expr_type::atom)
+		global_scope_guard()
+		{
+			saved.swap(stackframe);
+			this_var = variable::object(global_object);
+		}
+		~global_scope_guard()
+		{
+			stackframe.swap(saved);
+			if (!stackframe.empty())
+				this_var = stackframe.front().this_var;
+			else
+				this_var = variable::object(global_object);
+		}
+	} guard;
+
+	return it->second();
+}
+
+namespace aot
+{
+	module_registrar::module_registrar(const char* name, module_fn fn)
 	{
-		std::cout << "[atom] " << expr.value->ptr << "\n";
+		aot_modules()[name] = fn;
 	}
-	else if (expr.type == expr_type::string)
+
+	s_string* name(const char* str)
 	{
-		std::cout << "[string] " << expr.value->ptr << "\n";
+		return intern_string(create_string(str));
 	}
-	else if (expr.type == expr_type::number)
+
+	variable string(const char* str)
 	{
-		std::cout << "[number] " << expr.number << "\n";
+		return create_string(str)->var();
 	}
-	else
+
+	double number(variable v)
 	{
-		if (expr.list.empty())
-		{
-			std::cout << "( )\n";
-		}
-		else
-		{
-			std::cout << "(\n";
-			for (const auto& sub : expr.list)
-			{
-				dump_expr(sub, indent + 1);
-			}
-			std::cout << str_indent << ")\n";
-		}
+		if (v.type != var_type::number)
+			throw not_number_error();
+		return v.v_number;
+	}
+
+	variable getl(s_string* name)
+	{
+		auto pit = find_local(name);
+		return pit ? (*pit)->second : variable::undefined();
+	}
+
+	void setl(s_string* name, variable val)
+	{
+		assign_local(name, val);
+	}
+
+	s_object* field_object(variable v)
+	{
+		if (v.type != var_type::object)
+			throw not_object_error();
+		if (v.v_object == nullptr)
+			throw null_reference_error();
+		return v.v_object;
+	}
+
+	variable getf(s_object* obj, s_string* name)
+	{
+		return get_member(obj, name);
+	}
+
+	void setf(s_object* obj, s_string* name, variable val)
+	{
+		set_member(obj, name, val);
+	}
+
+	s_function* method(variable obj, s_string* name)
+	{
+		return find_method(obj, name);
+	}
+
+	s_function* function(variable v)
+	{
+		if (v.type == var_type::object && v.v_object != nullptr && v.v_object->type == object_type::function)
+			return (s_function*)v.v_object;
+		throw list_evaluate_error();
+	}
+
+	variable call(s_function* fn, variable this_value, const variable* args, std::size_t count)
+	{
+		s_array local_arguments;
+		s_array* arguments = prepare_arguments(fn, local_arguments);
+		arguments->vector.assign(args, args + count);
+		return call_function(fn, this_value, arguments);
+	}
+
+	s_function* constructor(variable v)
+	{
+		if (v.type != var_type::object)
+			throw not_object_error();
+		if (v.v_object == nullptr)
+			throw null_reference_error();
+		if (v.v_object->type != object_type::function)
+			throw not_function_error();
+		return (s_function*)v.v_object;
+	}
+
+	variable construct(s_function* ctor, const variable* args, std::size_t count)
+	{
+		s_array local_arguments;
+		s_array* arguments = prepare_arguments(ctor, local_arguments);
+		arguments->vector.assign(args, args + count);
+		return construct_object(ctor, arguments);
+	}
+
+	variable array(const variable* items, std::size_t count)
+	{
+		s_array* ret = create_array(elements_kind::packed_int);
+		ret->assign(items, count);
+		return ret->var();
+	}
+
+	const function_template* native_template(const char* const* parameters, std::size_t count, bool is_variadic, native_fn_t fn)
+	{
+		static std::vector<std::shared_ptr<function_template>> templates;
+
+		gc_vector<s_string*> par;
+		for (std::size_t i = 0; i < count; ++i)
+			par.push_back(create_string(parameters[i]));
+
+		templates.push_back(make_native_template(par, fn, is_variadic));
+		return templates.back().get();
+	}
+
+	variable make_function(const function_template* templ, s_string* name)
+	{
+		s_function* fn = create_function(templ, nullptr);
+		if (name != nullptr)
+			define_constructor(fn, name);
+		return fn->var();
+	}
+
+	const expression* parse(const char* source)
+	{
+		static std::vector<std::shared_ptr<expression>> trees;
+
+		auto expr = std::make_shared<expression>();
+		std::istringstream strm(std::string(source) + "\n");
+		read_expr(strm, *expr, expr);
+		optimize_expr(*expr);
+
+		trees.push_back(expr);
+		return expr.get();
+	}
+
+	variable eval(const expression* expr)
+	{
+		return eval_expr(*expr);
 	}
 }